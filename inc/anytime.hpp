@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace util::anytime {
+
+using Clock   = std::chrono::high_resolution_clock;
+using Elapsed = std::chrono::duration<double, std::milli>;
+
+// best cost of a run at some moment after its start
+struct Point {
+  Elapsed elapsed;
+  int     cost;
+};
+
+// wall clock limit of a solver, the clock is read only every CHECK_INTERVAL
+// iterations, 0 ms means no limit
+class Deadline {
+public:
+  constexpr static int CHECK_INTERVAL {16};
+
+  explicit Deadline(int millis) noexcept: start {Clock::now()}, millis {millis} {}
+
+  [[nodiscard]] bool passed(int itr) const noexcept {
+    if (millis == 0 || itr % CHECK_INTERVAL != 0) [[likely]] {
+      return false;
+    }
+    return Elapsed {Clock::now() - start}.count() >= millis;
+  }
+
+private:
+  Clock::time_point start;
+  int               millis;
+};
+
+// improvements of the best cost during one measured run, the last CAPACITY
+// of them are kept in a ring, the moment the target cost was first reached
+// is kept aside so it survives the ring wrapping, while alive it is the one
+// fed by record()
+class Recorder {
+public:
+  constexpr static size_t CAPACITY {1024};
+
+  explicit Recorder(std::optional<int> target_cost) noexcept;
+  ~Recorder() noexcept;
+
+  Recorder(const Recorder&)            = delete;
+  Recorder(Recorder&&)                 = delete;
+  Recorder& operator=(const Recorder&) = delete;
+  Recorder& operator=(Recorder&&)      = delete;
+
+  void record(int cost) noexcept;
+
+  // oldest first
+  [[nodiscard]] std::vector<Point> points() const noexcept;
+
+  [[nodiscard]] std::optional<Elapsed> time_to_target() const noexcept;
+
+private:
+  mutable std::mutex             mutex;
+  Clock::time_point              start;
+  std::array<Point, CAPACITY>    ring {};
+  size_t                         recorded {0};
+  int                            best_cost;
+  std::optional<int>             target_cost;
+  std::optional<Elapsed>         target_time;
+  Recorder*                      previous;
+};
+
+// solvers call it whenever their best cost drops, safe from any thread,
+// does nothing when no run is recorded
+void record(int cost) noexcept;
+
+// cost counted as reached for time to target, optimum + TARGET_PERCENT %
+constexpr int TARGET_PERCENT {1};
+
+[[nodiscard]] std::optional<int> target_cost(
+const std::optional<int>& optimal_cost) noexcept;
+
+}    // namespace util::anytime
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "rng.hpp"
+#include "util.hpp"
+
+#include <optional>
+#include <variant>
+#include <vector>
+
+namespace util::construct {
+
+// closes the path and sums its cost, none if an edge is missing
+[[nodiscard]] std::optional<tsp::Solution> close(
+const tsp::CostMatrix& matrix,
+std::vector<int>       path) noexcept;
+
+// single greedy path from the given root, ties go to the lower vertex, O(n^2)
+[[nodiscard]] std::optional<tsp::Solution> nearest_from(
+const tsp::CostMatrix& matrix,
+int                    root) noexcept;
+
+// uniformly random permutation, O(n)
+[[nodiscard]] std::optional<tsp::Solution> random_tour(
+const tsp::CostMatrix& matrix,
+rng::Xoshiro256&       engine) noexcept;
+
+// greedy edge matching, cheapest edges first while every vertex keeps at
+// most one successor and one predecessor (two neighbours when symmetric) and
+// no cycle closes before all vertices are on the path, O(n^2 log n)
+[[nodiscard]] std::optional<tsp::Solution> greedy_edge(
+const tsp::CostMatrix& matrix,
+bool                   symmetric) noexcept;
+
+// farthest insertion, the vertex farthest from the tour goes where it adds
+// the least cost, O(n^2)
+[[nodiscard]] std::optional<tsp::Solution> farthest_insertion(
+const tsp::CostMatrix& matrix) noexcept;
+
+// preorder walk of a minimum spanning tree, the doubled tree with repeated
+// vertices shortcut, edges weighted by the cheaper direction, O(n^2)
+[[nodiscard]] std::optional<tsp::Solution> mst_walk(
+const tsp::CostMatrix& matrix) noexcept;
+
+// starting tour of an improvement solver, the nearest neighbour solver when
+// it is chosen or the chosen heuristic finds no tour (missing edges)
+[[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> tour(
+const tsp::CostMatrix&    matrix,
+const tsp::GraphInfo&     graph_info,
+const std::optional<int>& optimal_cost,
+tsp::Construction         construction) noexcept;
+
+}    // namespace util::construct
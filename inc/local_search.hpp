@@ -0,0 +1,118 @@
+#pragma once
+
+#include "neighbours.hpp"
+#include "util.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace util::local_search {
+
+// first improvement local search on a closed tour (n + 1 entries) kept
+// together with its vertex -> position table, moves are only tried towards
+// vertices of the neighbour lists and a vertex is looked at again only after
+// a move touched its surroundings (don't-look bits), one engine per thread
+class Engine {
+public:
+  Engine(const tsp::CostMatrix&   matrix,
+         const neighbours::Lists& candidates,
+         bool                     symmetric) noexcept;
+
+  // both return the count of applied moves, at most max_moves (0 = until no
+  // move improves), path, positions and cost are updated in place
+
+  // reverse a segment, on asymmetric instances the segment is re-costed
+  int two_opt(std::span<int> path,
+              std::span<int> positions,
+              int&           cost,
+              int            max_moves) noexcept;
+
+  // move a segment of up to OR_OPT_MAX_LENGTH vertices elsewhere, reversed
+  // insertions are tried on symmetric instances
+  int or_opt(std::span<int> path,
+             std::span<int> positions,
+             int&           cost,
+             int            max_moves) noexcept;
+
+  // restricted 3-opt, a segment of any length starting after the vertex is
+  // moved further along the tour without reversal, so no edge changes
+  // direction and asymmetric instances need no re-costing
+  int three_opt(std::span<int> path,
+                std::span<int> positions,
+                int&           cost,
+                int            max_moves) noexcept;
+
+  // 2-opt, Or-opt and restricted 3-opt tried in turn at every vertex
+  int all(std::span<int> path,
+          std::span<int> positions,
+          int&           cost,
+          int            max_moves) noexcept;
+
+  // the neighbourhood chosen by kind, 0 moves for NONE
+  int improve(tsp::LocalSearch kind,
+              std::span<int>   path,
+              std::span<int>   positions,
+              int&             cost,
+              int              max_moves) noexcept;
+
+  // same on a closed tour without a position table, for solvers keeping
+  // plain solutions
+  int improve(tsp::LocalSearch kind,
+              tsp::Solution&   solution,
+              int              max_moves) noexcept;
+
+  constexpr static int OR_OPT_MAX_LENGTH {3};
+
+private:
+  template<typename Improve>
+  int run(std::span<int> path,
+          std::span<int> positions,
+          int&           cost,
+          int            max_moves,
+          Improve&&      improve) noexcept;
+
+  [[nodiscard]] bool improve_two_opt(int vertex) noexcept;
+  [[nodiscard]] bool improve_or_opt(int vertex) noexcept;
+  [[nodiscard]] bool improve_three_opt(int vertex) noexcept;
+
+  // cost change of reversing the segment between two positions on an
+  // asymmetric instance, nullopt if a reversed edge is missing
+  [[nodiscard]] std::optional<int> reversal_delta(int from, int to) const noexcept;
+
+  void reverse(int from, int to) noexcept;
+  void flip(int from, int length) noexcept;
+  void swap_blocks(int from, int first_length, int second_length) noexcept;
+  void move_segment(int from, int length, int after) noexcept;
+  void activate(int vertex) noexcept;
+
+  [[nodiscard]] int next(int vertex) const noexcept {
+    return path[(positions[vertex] + 1) % v_count];
+  }
+
+  [[nodiscard]] int prev(int vertex) const noexcept {
+    return path[(positions[vertex] + v_count - 1) % v_count];
+  }
+
+  const tsp::CostMatrix&   matrix;
+  const neighbours::Lists& candidates;
+  bool                     symmetric;
+  int                      v_count;
+
+  // tour of the current call
+  std::span<int> path;
+  std::span<int> positions;
+  int            delta_sum {0};
+
+  // vertices waiting to be looked at, each at most once
+  std::vector<char> active;
+  std::vector<int>  queue;
+  size_t            queue_head {0};
+  size_t            queue_size {0};
+
+  // position table of tours improved without one
+  std::vector<int> solution_positions;
+};
+
+}    // namespace util::local_search
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "util.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace util::neighbours {
+
+// k cheapest successors of every vertex in increasing cost order, built once
+// per instance and shared by the solvers, missing edges are never listed,
+// copies and narrowed views share the rows
+class Lists {
+public:
+  Lists() noexcept = default;
+  Lists(const tsp::CostMatrix& matrix, int k) noexcept;
+
+  // the first k entries of every list, O(1), k above the built width lists
+  // all entries
+  [[nodiscard]] Lists narrowed(int k) const noexcept;
+
+  [[nodiscard]] constexpr std::span<const int> of(int vertex) const noexcept {
+    return {candidates + static_cast<size_t>(vertex) * width,
+            static_cast<size_t>(std::min(counts[vertex], limit))};
+  }
+
+  // true when no lists were built, solvers then scan full neighbourhoods
+  [[nodiscard]] constexpr bool empty() const noexcept {
+    return limit == 0;
+  }
+
+  [[nodiscard]] constexpr int k() const noexcept {
+    return limit;
+  }
+
+private:
+  struct Rows {
+    std::vector<int> candidates;    // row of width entries per vertex
+    std::vector<int> counts;        // listed entries of each row
+  };
+
+  int                         width {0};    // entries of a stored row
+  int                         limit {0};    // entries of a row in this view
+  std::shared_ptr<const Rows> rows;
+  const int*                  candidates {nullptr};
+  const int*                  counts {nullptr};
+};
+
+}    // namespace util::neighbours
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util::parallel {
+
+// fixed set of worker threads kept alive between calls, work is handed out
+// as task indices taken from a shared counter
+class ThreadPool {
+public:
+  using Task = std::function<void(int worker, int task)>;
+
+  explicit ThreadPool(int thread_count) noexcept;
+  ~ThreadPool() noexcept;
+
+  ThreadPool(const ThreadPool&)            = delete;
+  ThreadPool(ThreadPool&&)                 = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool& operator=(ThreadPool&&)      = delete;
+
+  // calls task(worker, index) for every index in [0, task_count) and blocks
+  // until all of them finished, worker is in [0, size()), called from inside
+  // a task it runs everything on the calling thread
+  void run(int task_count, const Task& task) noexcept;
+
+  [[nodiscard]] int size() const noexcept;
+
+  // tasks of a run() from this thread that execute at the same time, 1 for
+  // a nested call, tasks waiting on each other must not outnumber it
+  [[nodiscard]] int concurrency() const noexcept;
+
+private:
+  void work(int worker) noexcept;
+
+  std::vector<std::thread> threads;
+  std::mutex               run_mutex;
+  std::mutex               state_mutex;
+  std::condition_variable  wake;
+  std::condition_variable  done;
+  const Task*              current_task {nullptr};
+  int                      task_count {0};
+  int                      next_task {0};
+  int                      busy_workers {0};
+  uint64_t                 generation {0};
+  bool                     stopping {false};
+};
+
+[[nodiscard]] int hardware_threads() noexcept;
+
+// pool shared by all algorithms, sized to the hardware
+[[nodiscard]] ThreadPool& shared_pool() noexcept;
+
+}    // namespace util::parallel
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace util::rng {
+
+// xoshiro256** generator, state filled by splitmix64 from a seed, stream i
+// is the seeded state moved forward by i jumps of 2^128 steps so threads of
+// one run never overlap, usable with the standard distributions
+class Xoshiro256 {
+public:
+  using result_type = uint64_t;
+
+  Xoshiro256(uint64_t seed, uint64_t stream) noexcept;
+
+  [[nodiscard]] constexpr static result_type min() noexcept {
+    return 0;
+  }
+
+  [[nodiscard]] constexpr static result_type max() noexcept {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() noexcept {
+    const uint64_t result {rotl(state[1] * 5, 7) * 9};
+    const uint64_t shifted {state[1] << 17};
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= shifted;
+    state[3]  = rotl(state[3], 45);
+
+    return result;
+  }
+
+  // uniform in [0, bound), multiply and shift with rejection of the biased
+  // low range, cheaper than std::uniform_int_distribution
+  [[nodiscard]] uint32_t below(uint32_t bound) noexcept {
+    uint64_t product {(operator()() >> 32) * bound};
+    if (static_cast<uint32_t>(product) < bound) [[unlikely]] {
+      const uint32_t threshold {(0u - bound) % bound};
+      while (static_cast<uint32_t>(product) < threshold) {
+        product = (operator()() >> 32) * bound;
+      }
+    }
+    return static_cast<uint32_t>(product >> 32);
+  }
+
+  // uniform in [low, high]
+  [[nodiscard]] int between(int low, int high) noexcept {
+    return low + static_cast<int>(below(static_cast<uint32_t>(high - low) + 1));
+  }
+
+private:
+  [[nodiscard]] constexpr static uint64_t rotl(uint64_t value,
+                                               int      shift) noexcept {
+    return (value << shift) | (value >> (64 - shift));
+  }
+
+  void jump() noexcept;
+
+  uint64_t state[4];
+};
+
+// seed for when none was given, from std::random_device
+[[nodiscard]] uint64_t random_seed() noexcept;
+
+// the next runs get seed, then seeds derived from it and the run index, so
+// a measured run is repeated by passing its own seed as the seed
+void set_seed(uint64_t seed) noexcept;
+
+// moves to the next run and returns its seed, called by measured_run
+uint64_t begin_run() noexcept;
+
+// seed of the run in progress, every generator of a solver derives from it
+[[nodiscard]] uint64_t run_seed() noexcept;
+
+// generator of one thread, island or start of the run in progress
+[[nodiscard]] Xoshiro256 stream(uint64_t index) noexcept;
+
+}    // namespace util::rng
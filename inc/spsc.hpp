@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace util::spsc {
+
+constexpr static size_t CACHE_LINE {64};
+
+// bounded lock-free queue for exactly one producing and one consuming
+// thread, elements are allocated once up front and filled in place, so
+// passing them through does not allocate
+template<typename T>
+class Queue {
+public:
+  Queue(size_t capacity, const T& prototype) noexcept:
+    slots(capacity + 1, prototype) {
+  }
+
+  // fill(T&) writes the element in place, false if the queue is full
+  template<typename Fill>
+  bool try_push(Fill&& fill) noexcept {
+    const size_t current_tail {tail.load(std::memory_order_relaxed)};
+    const size_t next_tail {(current_tail + 1) % slots.size()};
+    if (next_tail == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    fill(slots[current_tail]);
+    tail.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  // drain(const T&) reads the oldest element, false if the queue is empty
+  template<typename Drain>
+  bool try_pop(Drain&& drain) noexcept {
+    const size_t current_head {head.load(std::memory_order_relaxed)};
+    if (current_head == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    drain(std::as_const(slots[current_head]));
+    head.store((current_head + 1) % slots.size(), std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<T>                         slots;    // one is always left empty
+  alignas(CACHE_LINE) std::atomic<size_t> head {0};
+  alignas(CACHE_LINE) std::atomic<size_t> tail {0};
+};
+
+}    // namespace util::spsc
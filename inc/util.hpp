@@ -1,15 +1,22 @@
 #pragma once
 
+#include "anytime.hpp"
+#include "rng.hpp"
+
 #include <fmt/core.h>
 #include <type_traits>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <new>
 #include <optional>
 #include <ratio>
+#include <span>
 #include <string>
 #include <utility>
 #include <variant>
@@ -20,6 +27,98 @@ namespace tsp {
 template<typename T>
 using Matrix = std::vector<std::vector<T>>;
 
+template<typename T, size_t Alignment>
+requires (Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0)
+class AlignedAllocator {
+public:
+  using value_type = T;
+
+  template<typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  constexpr AlignedAllocator() noexcept = default;
+
+  template<typename U>
+  constexpr AlignedAllocator(    // NOLINT(*-explicit-constructor)
+  const AlignedAllocator<U, Alignment>&) noexcept {
+  }
+
+  [[nodiscard]] T* allocate(size_t count) {
+    return static_cast<T*>(
+    ::operator new(count * sizeof(T), std::align_val_t {Alignment}));
+  }
+
+  void deallocate(T* ptr, size_t) noexcept {
+    ::operator delete(ptr, std::align_val_t {Alignment});
+  }
+
+  template<typename U>
+  constexpr bool operator==(
+  const AlignedAllocator<U, Alignment>&) const noexcept {
+    return true;
+  }
+};
+
+// cost matrix stored row-major in a single cache line aligned buffer, every
+// row is padded to a whole number of cache lines (padding holds -1)
+class CostMatrix {
+public:
+  constexpr static size_t ALIGNMENT {64};
+  constexpr static size_t ROW_MULTIPLE {ALIGNMENT / sizeof(int)};
+
+  CostMatrix() noexcept = default;
+
+  explicit CostMatrix(size_t v_count, int fill = -1) noexcept:
+    v_count {v_count},
+    row_stride {(v_count + ROW_MULTIPLE - 1) / ROW_MULTIPLE * ROW_MULTIPLE},
+    cells(v_count * row_stride, -1) {
+    for (size_t from {0}; from < v_count; ++from) {
+      std::fill_n(row(from), v_count, fill);
+    }
+  }
+
+  [[nodiscard]] constexpr size_t size() const noexcept {
+    return v_count;
+  }
+
+  [[nodiscard]] constexpr bool empty() const noexcept {
+    return v_count == 0;
+  }
+
+  // distance in elements between the starts of two consecutive rows
+  [[nodiscard]] constexpr size_t stride() const noexcept {
+    return row_stride;
+  }
+
+  // unchecked access, cost of edge from -> to
+  [[nodiscard]] constexpr int& operator()(size_t from, size_t to) noexcept {
+    return cells[from * row_stride + to];
+  }
+
+  [[nodiscard]] constexpr int operator()(size_t from, size_t to) const noexcept {
+    return cells[from * row_stride + to];
+  }
+
+  [[nodiscard]] constexpr int* row(size_t from) noexcept {
+    return cells.data() + from * row_stride;
+  }
+
+  [[nodiscard]] constexpr const int* row(size_t from) const noexcept {
+    return cells.data() + from * row_stride;
+  }
+
+  [[nodiscard]] constexpr const int* data() const noexcept {
+    return cells.data();
+  }
+
+private:
+  size_t                                             v_count {0};
+  size_t                                             row_stride {0};
+  std::vector<int, AlignedAllocator<int, ALIGNMENT>> cells;
+};
+
 using Time = std::chrono::duration<double, std::milli>;
 
 enum class State : uint_fast8_t {
@@ -38,10 +137,12 @@ enum class Algorithm : uint_fast8_t {
   BXB_LEAST_COST,
   BXB_BFS,
   BXB_DFS,
+  HELD_KARP,
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
   TABU_SEARCH,
+  LOCAL_SEARCH,
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -60,6 +161,7 @@ enum class ErrorConfig : uint_fast8_t {
 enum class ErrorAlgorithm : uint_fast8_t {
   NO_PATH,
   INVALID_PARAM,
+  TOO_LARGE,
 };
 
 enum class ErrorArg : uint_fast8_t {
@@ -79,13 +181,15 @@ enum class ErrorMeasure : uint_fast8_t {
 };
 
 struct MeasuringRun {
-  std::array<Algorithm, 8> algorithms;
-  bool                     verbose;
+  std::array<Algorithm, 10> algorithms;
+  bool                      verbose;
+  std::optional<uint64_t>   seed;    // --seed=, random when not given
 };
 
 struct SingleRun {
-  Algorithm             algorithm;
-  std::filesystem::path config_file;
+  Algorithm               algorithm;
+  std::filesystem::path   config_file;
+  std::optional<uint64_t> seed;    // --seed=, takes precedence over the config
 };
 
 using Arguments = std::variant<MeasuringRun, SingleRun>;
@@ -95,38 +199,105 @@ struct Solution {
   int              cost;
 };
 
+// heuristic building the starting tour of an improvement solver
+enum class Construction : uint_fast8_t {
+  NEAREST_NEIGHBOUR,    // single greedy path
+  GREEDY,               // greedy edge matching
+  INSERTION,            // farthest insertion
+  MST,                  // minimum spanning tree walk
+};
+
+// neighbourhood of the local search engine
+enum class LocalSearch : uint_fast8_t {
+  NONE,
+  TWO_OPT,      // segment reversal
+  OR_OPT,       // move of up to 3 vertices
+  THREE_OPT,    // move of a segment of any length, restricted 3-opt
+  ALL,          // all three at every vertex
+};
+
 #if defined(ZADANIE1) && ZADANIE1 == 1
+struct ParamNearestNeighbour {
+  int beam;    // partial tours kept per step, 1 -> single greedy path
+};
+
 struct ParamRandom {
   int millis;
 };
 #endif
 
+#if defined(ZADANIE2) && ZADANIE2 == 1
+struct ParamBranchAndBound {
+  Construction initial;    // tour giving the first upper bound
+};
+#endif
+
 #if defined(ZADANIE3) && ZADANIE3 == 1
+enum class Neighbourhood : uint_fast8_t {
+  SWAP,       // exchange two vertices
+  TWO_OPT,    // reverse a segment
+  OR_OPT,     // move a segment of up to 3 vertices
+};
+
 struct ParamTabuSearch {
-  int itr;
-  int max_itr_no_improve;
-  int tabu_itr;
+  int           itr;
+  int           max_itr_no_improve;
+  int           tabu_itr;
+  Neighbourhood neighbourhood;
+  int           candidates;      // nearest neighbours per vertex, 0 -> all
+  int           threads;         // threads scanning the neighbourhood
+  int           starts;          // independent searches sharing an elite pool
+  LocalSearch   local_search;    // polishes the best tour
+  Construction  initial;         // starting tour
+  int           millis;          // wall clock limit, 0 -> none
+};
+
+struct ParamLocalSearch {
+  LocalSearch  method;
+  int          candidates;    // nearest neighbours per vertex
+  Construction initial;       // tour improved to a local optimum
 };
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
+enum class Crossover : uint_fast8_t {
+  SPLICE,    // segment of the second parent spliced into the first
+  OX,        // order crossover
+  PMX,       // partially mapped crossover
+  ERX,       // edge recombination of both parents' edges
+};
+
 struct ParamGenetic {
-  int itr;
-  int population_size;
-  int children_per_itr;
-  int max_children_per_pair;
-  int max_v_count_crossover;
-  int mutations_per_1000;
+  int          itr;
+  int          population_size;
+  int          children_per_itr;
+  int          max_children_per_pair;
+  int          max_v_count_crossover;
+  int          mutations_per_1000;
+  Crossover    crossover;
+  LocalSearch  local_search;          // applied to every child
+  int          local_search_moves;    // moves per child, 0 -> until local optimum
+  int          islands;               // populations evolved on their own threads
+  int          migration_interval;    // generations between migrations
+  int          migrants;              // best chromosomes sent to the next island
+  Construction initial;               // tour the population is derived from
+  int          millis;                // wall clock limit, 0 -> none
 };
 #endif
 
 struct Param {
 #if defined(ZADANIE1) && ZADANIE1 == 1
-  ParamRandom random;
+  ParamNearestNeighbour nearest_neighbour;
+  ParamRandom           random;
+#endif
+
+#if defined(ZADANIE2) && ZADANIE2 == 1
+  ParamBranchAndBound branch_and_bound;
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
-  ParamTabuSearch tabu_search;
+  ParamTabuSearch  tabu_search;
+  ParamLocalSearch local_search;
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -140,12 +311,13 @@ struct GraphInfo {
 };
 
 struct Instance {
-  Matrix<int>           matrix;
-  std::filesystem::path config_file;
-  std::filesystem::path input_file;
-  Solution              optimal;
-  Param                 params;
-  GraphInfo             graph_info;
+  CostMatrix              matrix;
+  std::filesystem::path   config_file;
+  std::filesystem::path   input_file;
+  Solution                optimal;
+  Param                   params;
+  GraphInfo               graph_info;
+  std::optional<uint64_t> seed;
 };
 
 struct Error {
@@ -153,10 +325,20 @@ struct Error {
   double relative_percent;
 };
 
+// node counts of a single search worker thread
+struct ThreadStats {
+  long long expanded;    // nodes branched into children
+  long long pruned;      // nodes cut off by the bound
+  long long leaves;      // complete paths evaluated
+};
+
 struct Result {
-  Solution             solution;
-  Time                 time;
-  std::optional<Error> error_info;
+  Solution                          solution;
+  Time                              time;
+  std::optional<Error>              error_info;
+  std::vector<util::anytime::Point> trace;             // best cost improvements
+  std::optional<Time>               time_to_target;    // optimum + 1% reached
+  uint64_t                          seed;              // repeats the run
 };
 
 struct Duration {
@@ -177,15 +359,18 @@ void help_page() noexcept;
 
 namespace util::output {
 
-void report(const tsp::SingleRun& arguments,
-            const tsp::Instance&  instance,
-            const tsp::Result&    result) noexcept;
+// thread_stats of the workers of the run, empty when the algorithm keeps
+// none
+void report(const tsp::SingleRun&             arguments,
+            const tsp::Instance&              instance,
+            const tsp::Result&                result,
+            std::span<const tsp::ThreadStats> thread_stats) noexcept;
 
 }    // namespace util::output
 
 namespace util::input {
 
-[[nodiscard]] std::variant<tsp::Matrix<int>, tsp::ErrorRead> tsp_matrix(
+[[nodiscard]] std::variant<tsp::CostMatrix, tsp::ErrorRead> tsp_matrix(
 const std::filesystem::path& input_file) noexcept;
 
 void help_page() noexcept;
@@ -227,6 +412,10 @@ tsp::State handle(const std::variant<Ret, Error>& result) noexcept {
           config::help_page();
           return tsp::State::ERROR;
 
+        case tsp::ErrorAlgorithm::TOO_LARGE:
+          fmt::println("Instance is too large for this algorithm!");
+          return tsp::State::ERROR;
+
         default:
           fmt::println("Something went wrong!");
           return tsp::State::ERROR;
@@ -334,22 +523,25 @@ namespace util {
 
 template<typename Func, typename... Params>
 requires std::invocable<Func,
-                        const tsp::Matrix<int>&,
+                        const tsp::CostMatrix&,
                         const tsp::GraphInfo&,
                         const std::optional<int>&,
                         Params...> &&
          std::is_same_v<std::invoke_result_t<Func,
-                                             const tsp::Matrix<int>&,
+                                             const tsp::CostMatrix&,
                                              const tsp::GraphInfo&,
                                              const std::optional<int>&,
                                              Params...>,
                         std::variant<tsp::Solution, tsp::ErrorAlgorithm>>
 [[nodiscard]] std::variant<tsp::Result, tsp::ErrorAlgorithm> measured_run(
 Func                      algorithm,
-const tsp::Matrix<int>&   matrix,
+const tsp::CostMatrix&    matrix,
 const tsp::GraphInfo&     graph_info,
 const std::optional<int>& optimal_cost,
 Params&&... params) noexcept {
+  const uint64_t                seed {util::rng::begin_run()};
+  const util::anytime::Recorder recorder {
+    util::anytime::target_cost(optimal_cost)};
   const auto start {std::chrono::high_resolution_clock::now()};
 
   const std::variant<tsp::Solution, tsp::ErrorAlgorithm> solution_result {
@@ -374,7 +566,10 @@ Params&&... params) noexcept {
         .absolute = solution.cost - *optimal_cost,
         .relative_percent =
         ((static_cast<double>(solution.cost) / *optimal_cost) - 1.) * 100.}}
-    : std::nullopt};
+    : std::nullopt,
+    recorder.points(),
+    recorder.time_to_target(),
+    seed};
 }
 
 }    // namespace util
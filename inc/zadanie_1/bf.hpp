@@ -5,7 +5,7 @@
 namespace bf {
 
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>& matrix,
+const tsp::CostMatrix&  matrix,
 const tsp::GraphInfo&   graph_info,
 const std::optional<int>&      optimal_cost) noexcept;
 
@@ -4,9 +4,15 @@
 
 namespace nn {
 
+// beam width of the plain greedy tour, used where nn is only an upper bound
+constexpr static int SINGLE_PATH {1};
+
+// greedy tours from every start (only vertex 0 on full symmetric graphs),
+// beam_width partial tours kept per step, SINGLE_PATH follows one
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>& matrix,
+const tsp::CostMatrix&  matrix,
 const tsp::GraphInfo&   graph_info,
-const std::optional<int>&      optimal_cost) noexcept;
+const std::optional<int>&      optimal_cost,
+int                     beam_width) noexcept;
 
 }    // namespace nn
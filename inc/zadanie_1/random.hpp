@@ -5,7 +5,7 @@
 namespace random {
 
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>& matrix,
+const tsp::CostMatrix&  matrix,
 const tsp::GraphInfo&,
 const std::optional<int>&      optimal_cost,
 int                     time_ms) noexcept;
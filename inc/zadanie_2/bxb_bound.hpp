@@ -0,0 +1,119 @@
+#pragma once
+
+#include "util.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bxb::bound {
+
+enum class Kind : uint_fast8_t {
+  MIN_EDGE,     // cheapest edge into/out of every unfinished vertex, O(1)
+  REDUCTION,    // row/column reduction (Little) carried from the parent, O(k)
+};
+
+// part of the bound every node carries, so a child updates it in O(1)
+struct Remainder {
+  int out;    // sum of cheapest outgoing edges of vertices still to be left
+  int in;     // sum of cheapest incoming edges of vertices still to be entered
+};
+
+// reduction of the remaining matrix kept as potentials, the reduced cost of
+// an edge is cost - row[from] - column[to] and is never negative on edges
+// still usable, so a child only re-reduces rows and columns that lost their
+// zero, empty for MIN_EDGE
+struct Potentials {
+  std::vector<int> values;    // row potential of every vertex, then column
+  int              total;     // sum over rows to be left and columns entered
+};
+
+// lower bound on the cost of any tour completing a partial path
+// (starting vertex -> ... -> last), one engine per search thread
+class Engine {
+public:
+  Engine(const tsp::CostMatrix& matrix, int starting_vertex, Kind kind) noexcept;
+
+  [[nodiscard]] Remainder root() const noexcept;
+
+  // full reduction of the matrix for the path holding only the start
+  [[nodiscard]] Potentials root_potentials() const noexcept;
+
+  [[nodiscard]] constexpr Remainder child(const Remainder& parent,
+                                          int              from,
+                                          int to) const noexcept {
+    return {.out = parent.out - min_out[from], .in = parent.in - min_in[to]};
+  }
+
+  // bound of the child extending the parent path by from -> to, is_used
+  // tells if a vertex is on the child path, max_cost lets the evaluation
+  // stop early, any result >= max_cost means the node is pruned, otherwise
+  // potentials() holds the reduction of the child
+  template<typename IsUsed>
+  requires std::predicate<IsUsed, int>
+  [[nodiscard]] int evaluate(IsUsed&&          is_used,
+                             int               from,
+                             int               to,
+                             int               cost,
+                             const Remainder&  remainder,
+                             const Potentials& parent,
+                             int               max_cost) noexcept {
+    const int min_edge_bound {cost + std::max(remainder.out, remainder.in)};
+
+    if (kind == Kind::MIN_EDGE || min_edge_bound >= max_cost) {
+      return min_edge_bound;
+    }
+
+    remaining.clear();
+    for (int vertex {0}; vertex < static_cast<int>(matrix->size());
+         ++vertex) {
+      if (!is_used(vertex)) {
+        remaining.emplace_back(vertex);
+      }
+    }
+
+    // only the return to start is left, the leaf check prices it
+    if (remaining.empty()) [[unlikely]] {
+      return min_edge_bound;
+    }
+
+    const int reduction_bound {
+      reduce(remaining, parent, from, to, max_cost - cost)};
+    if (reduction_bound >= max_cost - cost) {
+      return max_cost;
+    }
+
+    return std::max(min_edge_bound, cost + reduction_bound);
+  }
+
+  // reduction of the last child evaluate() did not prune
+  [[nodiscard]] constexpr const Potentials& potentials() const noexcept {
+    return scratch;
+  }
+
+  [[nodiscard]] constexpr int starting_vertex() const noexcept {
+    return start;
+  }
+
+private:
+  // parent potentials without row from and column to, re-reduced on the
+  // rows and columns whose zero was removed with them or with the now
+  // closed to -> start edge, returns the child reduction total
+  [[nodiscard]] int reduce(std::span<const int> remaining_v,
+                           const Potentials&    parent,
+                           int                  from,
+                           int                  to,
+                           int                  max_extra) noexcept;
+
+  const tsp::CostMatrix* matrix;
+  int                    start;
+  Kind                   kind;
+  std::vector<int>       min_out;
+  std::vector<int>       min_in;
+  std::vector<int>       remaining;
+  Potentials             scratch;
+};
+
+}    // namespace bxb::bound
@@ -5,8 +5,9 @@
 namespace bxb::dfs {
 
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>& matrix,
+const tsp::CostMatrix&  matrix,
 const tsp::GraphInfo&   graph_info,
-const std::optional<int>&     optimal_cost) noexcept;
+const std::optional<int>&     optimal_cost,
+tsp::Construction       initial) noexcept;
 
 }    // namespace bxb::dfs
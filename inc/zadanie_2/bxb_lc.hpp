@@ -2,11 +2,16 @@
 
 #include "util.hpp"
 
+#include <vector>
+
 namespace bxb::lc {
 
+// thread_stats gets one entry per worker thread when not null
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>& matrix,
-const tsp::GraphInfo&   graph_info,
-const std::optional<int>&      optimal_cost) noexcept;
+const tsp::CostMatrix&         matrix,
+const tsp::GraphInfo&          graph_info,
+const std::optional<int>&      optimal_cost,
+tsp::Construction              initial,
+std::vector<tsp::ThreadStats>* thread_stats) noexcept;
 
 }    // namespace bxb::lc
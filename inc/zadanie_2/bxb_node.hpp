@@ -0,0 +1,112 @@
+#pragma once
+
+#include "zadanie_2/bxb_bound.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace bxb::node {
+
+// one bit per vertex, a single word covers instances up to 64 vertices
+template<size_t Words>
+class Mask {
+public:
+  constexpr void set(int vertex) noexcept {
+    bits[vertex >> 6] |= uint64_t {1} << (vertex & 63);
+  }
+
+  constexpr void reset(int vertex) noexcept {
+    bits[vertex >> 6] &= ~(uint64_t {1} << (vertex & 63));
+  }
+
+  [[nodiscard]] constexpr bool test(int vertex) const noexcept {
+    return ((bits[vertex >> 6] >> (vertex & 63)) & 1) != 0;
+  }
+
+private:
+  std::array<uint64_t, Words> bits {};
+};
+
+constexpr static size_t MAX_MASK_WORDS {8};
+
+// index of a path step in the arena
+using Link = uint32_t;
+
+constexpr static Link NO_LINK {std::numeric_limits<Link>::max()};
+
+// search node, the path is not copied into children, it is kept in the arena
+// as a chain of links and rebuilt only when a leaf is reached
+template<size_t Words>
+struct Node {
+  Mask<Words>       visited;
+  bound::Remainder  remainder;
+  bound::Potentials potentials;
+  Link              link;
+  int               last;
+  int               cost;
+  int               lower_bound;
+  int               depth;
+};
+
+// append only storage of (parent, vertex) steps of one search, grows in
+// fixed chunks so links stay valid and threads may append concurrently,
+// steps of pruned nodes are never reclaimed so a long search can fill it
+class Arena {
+public:
+  Arena() noexcept;
+
+  Arena(const Arena&)            = delete;
+  Arena(Arena&&)                 = delete;
+  Arena& operator=(const Arena&) = delete;
+  Arena& operator=(Arena&&)      = delete;
+  ~Arena() noexcept              = default;
+
+  // NO_LINK once every link is taken, the search has to stop then
+  [[nodiscard]] Link append(Link parent, int vertex) noexcept;
+
+  // vertices from the root step up to last, depth is the path length
+  [[nodiscard]] std::vector<int> path(Link last, int depth) const noexcept;
+
+private:
+  struct Step {
+    Link parent;
+    int  vertex;
+  };
+
+  constexpr static size_t CHUNK_BITS {16};
+  constexpr static size_t CHUNK_SIZE {size_t {1} << CHUNK_BITS};
+  constexpr static size_t CHUNK_COUNT {size_t {1} << (32 - CHUNK_BITS)};
+
+  std::unique_ptr<std::atomic<Step*>[]>  chunks;
+  std::vector<std::unique_ptr<Step[]>>   owned;
+  std::mutex                             grow_mutex;
+  std::atomic<uint64_t>                  next {0};    // never wraps
+};
+
+// true if the visited set of the instance fits in the widest mask
+[[nodiscard]] constexpr bool fits(size_t v_count) noexcept {
+  return v_count <= MAX_MASK_WORDS * 64;
+}
+
+// calls search.template operator()<Words>() with the narrowest mask able to
+// hold v_count vertices, v_count has to pass fits()
+template<typename Search>
+void dispatch(size_t v_count, Search&& search) noexcept {
+  if (v_count <= 64) [[likely]] {
+    search.template operator()<1>();
+  } else if (v_count <= 128) {
+    search.template operator()<2>();
+  } else if (v_count <= 256) {
+    search.template operator()<4>();
+  } else {
+    search.template operator()<MAX_MASK_WORDS>();
+  }
+}
+
+}    // namespace bxb::node
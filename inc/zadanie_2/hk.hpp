@@ -0,0 +1,12 @@
+#pragma once
+
+#include "util.hpp"
+
+namespace hk {
+
+[[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
+const tsp::CostMatrix&    matrix,
+const tsp::GraphInfo&     graph_info,
+const std::optional<int>& optimal_cost) noexcept;
+
+}    // namespace hk
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "util.hpp"
+
+namespace ls {
+
+// starting tour of the chosen construction improved to a local optimum of
+// the chosen neighbourhood, moves only towards the candidate_count nearest
+// neighbours of every vertex
+[[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
+const tsp::CostMatrix&    matrix,
+const tsp::GraphInfo&     graph_info,
+const std::optional<int>& optimal_cost,
+tsp::LocalSearch          method,
+int                       candidate_count,
+tsp::Construction         initial) noexcept;
+
+}    // namespace ls
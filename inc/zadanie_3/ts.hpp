@@ -1,15 +1,31 @@
 #pragma once
 
+#include "neighbours.hpp"
 #include "util.hpp"
 
 namespace ts {
 
+// width of the neighbour lists run needs, candidate_count for the tabu moves
+// and the lists of the local search polishing the best tour
+[[nodiscard]] int neighbour_width(int              candidate_count,
+                                  tsp::LocalSearch local_search) noexcept;
+
+// neighbours are the lists of the instance, at least neighbour_width wide,
+// the search and the polishing take views of them
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>& matrix,
-const tsp::GraphInfo&   graph_info,
+const tsp::CostMatrix&         matrix,
+const tsp::GraphInfo&          graph_info,
 const std::optional<int>&      optimal_cost,
-int                     itr_count,
-int                     no_improve_stop_itr_count,
-int                     tabu_itr_count) noexcept;
+int                            itr_count,
+int                            no_improve_stop_itr_count,
+int                            tabu_itr_count,
+tsp::Neighbourhood             neighbourhood,
+int                            candidate_count,
+const util::neighbours::Lists& neighbours,
+int                            thread_count,
+int                            start_count,
+tsp::LocalSearch               local_search,
+tsp::Construction              initial,
+int                            time_ms) noexcept;
 
 }    // namespace ts
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ts::kernel {
+
+// one row of the swap neighbourhood: the vertex at position first against
+// every position in [from, to), none of them adjacent to first, with the
+// pair (0, n - 1) left out, these cases are evaluated by the caller
+struct SwapRow {
+  const int* costs;               // flat cost matrix
+  size_t     stride;              // ints per matrix row
+  const int* path;                // closed path, n + 1 entries
+  const int* tabu_expiry;         // triangular tabu list
+  int        itr;                 // current iteration of the tabu list
+  int        v_count;
+  int        first;               // position of the fixed vertex
+  int        from;
+  int        to;
+  int        aspiration_delta;    // deltas below it override tabu
+};
+
+struct RowBest {
+  int delta_cost;    // INT_MAX when no allowed swap was found
+  int second;        // position of the best swap, the lowest on ties
+};
+
+// best allowed swap of the row, AVX2 when the cpu has it, scalar otherwise
+[[nodiscard]] RowBest swap_row(const SwapRow& row) noexcept;
+
+[[nodiscard]] bool uses_avx2() noexcept;
+
+}    // namespace ts::kernel
@@ -1,18 +1,32 @@
 #pragma once
 
+#include "neighbours.hpp"
 #include "util.hpp"
 
 namespace gen {
 
+// width of the neighbour lists run needs for the local search of children
+[[nodiscard]] int neighbour_width(tsp::LocalSearch local_search) noexcept;
+
+// neighbours are the lists of the instance, at least neighbour_width wide
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>& matrix,
-const tsp::GraphInfo&   graph_info,
+const tsp::CostMatrix&         matrix,
+const tsp::GraphInfo&          graph_info,
 const std::optional<int>&      optimal_cost,
-int                     count_of_itr,
-int                     population_size,
-int                     count_of_children,
-int                     max_children_per_pair,
-int                     max_v_count_crossover,
-int                     mutations_per_1000) noexcept;
+int                            count_of_itr,
+int                            population_size,
+int                            count_of_children,
+int                            max_children_per_pair,
+int                            max_v_count_crossover,
+int                            mutations_per_1000,
+tsp::Crossover                 crossover,
+tsp::LocalSearch               local_search,
+int                            local_search_moves,
+const util::neighbours::Lists& neighbours,
+int                            island_count,
+int                            migration_interval,
+int                            migrant_count,
+tsp::Construction              initial,
+int                            time_ms) noexcept;
 
 }    // namespace gen
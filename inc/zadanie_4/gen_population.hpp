@@ -0,0 +1,147 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gen::population {
+
+// index of a chromosome buffer in the pool
+using Slot = int;
+
+// zobrist keys, one random 64 bit key per edge, the same key for both
+// directions on symmetric instances, read only so islands share one table
+class EdgeKeys {
+public:
+  EdgeKeys(int v_count, bool symmetric) noexcept;
+
+  [[nodiscard]] uint64_t operator()(int from, int to) const noexcept {
+    return keys[from * v_count + to];
+  }
+
+private:
+  size_t                v_count;
+  std::vector<uint64_t> keys;    // n * n, like the cost matrix
+};
+
+// open addressing set of tour hashes, linear probing with backward shift
+// erase so no tombstones pile up between generations
+class TourSet {
+public:
+  explicit TourSet(int capacity) noexcept;
+
+  // false if the hash is already present
+  bool insert(uint64_t hash) noexcept;
+
+  void erase(uint64_t hash) noexcept;
+
+private:
+  struct Entry {
+    uint64_t hash;
+    bool     used;
+  };
+
+  [[nodiscard]] size_t home(uint64_t hash) const noexcept {
+    return static_cast<size_t>(hash) & mask;
+  }
+
+  void grow() noexcept;
+
+  std::vector<Entry> entries;
+  size_t             mask;
+  size_t             count {0};
+};
+
+// chromosomes of one run in a single flat buffer, a slot holds the closed
+// path (n + 1 genes) followed by the vertex -> path index table (n genes),
+// buffers of dropped chromosomes are recycled, members are kept as slots
+// sorted by cost so selection by rank is O(1), every slot carries a zobrist
+// hash of its tour (xor of edge keys) so a rotated or, on symmetric
+// instances, reversed copy of a member is never a second member
+class Population {
+public:
+  Population(int v_count, int capacity, const EdgeKeys& edge_keys) noexcept;
+
+  // free buffer with undefined contents, the pool grows only when all
+  // capacity slots are taken, spans taken before may then be invalidated
+  [[nodiscard]] Slot acquire() noexcept;
+
+  void release(Slot slot) noexcept;
+
+  // genes, cost and hash of one slot into another
+  void copy(Slot from, Slot to) noexcept;
+
+  // hash of the slot from its path, O(n), for tours changed as a whole
+  void rehash(Slot slot) noexcept;
+
+  // adds an acquired slot to the members, if the same tour already is one
+  // the slot is released and false returned
+  bool insert(Slot slot) noexcept;
+
+  // keeps the count best members, the rest goes back to the pool
+  void cut(size_t count) noexcept;
+
+  [[nodiscard]] std::span<int> path(Slot slot) noexcept {
+    return {genes.data() + slot * stride, v_count + 1};
+  }
+
+  [[nodiscard]] std::span<const int> path(Slot slot) const noexcept {
+    return {genes.data() + slot * stride, v_count + 1};
+  }
+
+  [[nodiscard]] std::span<int> vertices(Slot slot) noexcept {
+    return {genes.data() + slot * stride + v_count + 1, v_count};
+  }
+
+  [[nodiscard]] std::span<const int> vertices(Slot slot) const noexcept {
+    return {genes.data() + slot * stride + v_count + 1, v_count};
+  }
+
+  [[nodiscard]] int& cost(Slot slot) noexcept {
+    return costs[slot];
+  }
+
+  [[nodiscard]] int cost(Slot slot) const noexcept {
+    return costs[slot];
+  }
+
+  // kept in step with the path by whoever edits it, xor edge_key of every
+  // removed and added edge
+  [[nodiscard]] uint64_t& hash(Slot slot) noexcept {
+    return hashes[slot];
+  }
+
+  [[nodiscard]] uint64_t hash(Slot slot) const noexcept {
+    return hashes[slot];
+  }
+
+  [[nodiscard]] uint64_t edge_key(int from, int to) const noexcept {
+    return edge_keys(from, to);
+  }
+
+  // member of the given rank, 0 is the best one
+  [[nodiscard]] Slot at(size_t rank) const noexcept {
+    return members[rank];
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return members.size();
+  }
+
+private:
+  [[nodiscard]] std::weak_ordering compare(Slot lhs, Slot rhs) const noexcept;
+
+  size_t                v_count;
+  size_t                stride;
+  const EdgeKeys&       edge_keys;
+  std::vector<int>      genes;
+  std::vector<int>      costs;
+  std::vector<uint64_t> hashes;
+  std::vector<Slot>     members;       // sorted by compare
+  std::vector<Slot>     free_slots;
+  TourSet               member_hashes;
+};
+
+}    // namespace gen::population
@@ -0,0 +1,75 @@
+#include "anytime.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+namespace util::anytime {
+
+namespace {
+
+std::atomic<Recorder*> active {nullptr};
+
+}    // namespace
+
+Recorder::Recorder(const std::optional<int> target_cost) noexcept:
+  start {Clock::now()},
+  best_cost {std::numeric_limits<int>::max()},
+  target_cost {target_cost},
+  previous {active.exchange(this)} {}
+
+Recorder::~Recorder() noexcept {
+  active.store(previous);
+}
+
+void Recorder::record(const int cost) noexcept {
+  const std::scoped_lock lock {mutex};
+
+  // searches running in parallel may report costs already beaten
+  if (cost >= best_cost) {
+    return;
+  }
+  best_cost = cost;
+
+  const Elapsed elapsed {Clock::now() - start};
+  ring.at(recorded % CAPACITY) = Point {.elapsed = elapsed, .cost = cost};
+  ++recorded;
+
+  if (!target_time.has_value() && target_cost.has_value() &&
+      cost <= *target_cost) {
+    target_time = elapsed;
+  }
+}
+
+std::vector<Point> Recorder::points() const noexcept {
+  const std::scoped_lock lock {mutex};
+
+  const size_t       kept {std::min(recorded, CAPACITY)};
+  std::vector<Point> result {};
+  result.reserve(kept);
+  for (size_t i {recorded - kept}; i < recorded; ++i) {
+    result.push_back(ring.at(i % CAPACITY));
+  }
+  return result;
+}
+
+std::optional<Elapsed> Recorder::time_to_target() const noexcept {
+  const std::scoped_lock lock {mutex};
+  return target_time;
+}
+
+void record(const int cost) noexcept {
+  if (Recorder* recorder {active.load(std::memory_order_acquire)};
+      recorder != nullptr) {
+    recorder->record(cost);
+  }
+}
+
+std::optional<int> target_cost(const std::optional<int>& optimal_cost) noexcept {
+  if (!optimal_cost.has_value()) {
+    return std::nullopt;
+  }
+  return *optimal_cost + *optimal_cost * TARGET_PERCENT / 100;
+}
+
+}    // namespace util::anytime
@@ -0,0 +1,341 @@
+#include "construct.hpp"
+
+#include "zadanie_1/nn.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace util::construct {
+
+namespace {
+
+// cost of from -> to, a vertex reaches itself for free so a tour of a single
+// vertex can be inserted into
+[[nodiscard]] int edge(const tsp::CostMatrix& matrix,
+                       int                    from,
+                       int                    to) noexcept {
+  return from == to ? 0 : matrix(from, to);
+}
+
+// weight of an unordered pair, the cheaper existing direction, -1 if none
+[[nodiscard]] int weight(const tsp::CostMatrix& matrix,
+                         int                    first,
+                         int                    second) noexcept {
+  const int there {matrix(first, second)};
+  const int back {matrix(second, first)};
+  if (there == -1 || back == -1) {
+    return std::max(there, back);
+  }
+  return std::min(there, back);
+}
+
+}    // namespace
+
+std::optional<tsp::Solution> close(const tsp::CostMatrix& matrix,
+                                   std::vector<int>       path) noexcept {
+  path.push_back(path.front());
+
+  int cost {0};
+  for (size_t v {0}; v < path.size() - 1; ++v) {
+    const int edge_cost {matrix(path[v], path[v + 1])};
+    if (edge_cost == -1) [[unlikely]] {
+      return std::nullopt;
+    }
+    cost += edge_cost;
+  }
+
+  return tsp::Solution {.path = std::move(path), .cost = cost};
+}
+
+std::optional<tsp::Solution> nearest_from(const tsp::CostMatrix& matrix,
+                                          int root) noexcept {
+  const int         v_count {static_cast<int>(matrix.size())};
+  std::vector<bool> visited (v_count, false);
+  std::vector<int>  path {};
+  path.reserve(v_count + 1);
+
+  int current {root};
+  visited[root] = true;
+  path.push_back(root);
+
+  for (int step {1}; step < v_count; ++step) {
+    int next {-1};
+    for (int v {0}; v < v_count; ++v) {
+      if (visited[v] || matrix(current, v) == -1) {
+        continue;
+      }
+      if (next == -1 || matrix(current, v) < matrix(current, next)) {
+        next = v;
+      }
+    }
+    if (next == -1) [[unlikely]] {
+      return std::nullopt;
+    }
+
+    visited[next] = true;
+    path.push_back(next);
+    current = next;
+  }
+
+  return close(matrix, std::move(path));
+}
+
+std::optional<tsp::Solution> random_tour(const tsp::CostMatrix& matrix,
+                                         rng::Xoshiro256& engine) noexcept {
+  std::vector<int> path (matrix.size());
+  std::iota(path.begin(), path.end(), 0);
+  std::ranges::shuffle(path, engine);
+
+  return close(matrix, std::move(path));
+}
+
+std::optional<tsp::Solution> greedy_edge(const tsp::CostMatrix& matrix,
+                                         bool symmetric) noexcept {
+  struct Edge {
+    int cost;
+    int from;
+    int to;
+  };
+
+  const int         v_count {static_cast<int>(matrix.size())};
+  std::vector<Edge> edges {};
+  edges.reserve(static_cast<size_t>(v_count) * (v_count - 1));
+  for (int from {0}; from < v_count; ++from) {
+    for (int to {symmetric ? from + 1 : 0}; to < v_count; ++to) {
+      if (from != to && matrix(from, to) != -1) {
+        edges.push_back({.cost = matrix(from, to), .from = from, .to = to});
+      }
+    }
+  }
+  std::ranges::sort(edges, [](const Edge& lhs, const Edge& rhs) noexcept {
+    return std::tie(lhs.cost, lhs.from, lhs.to) <
+           std::tie(rhs.cost, rhs.from, rhs.to);
+  });
+
+  // links[v] -> {predecessor, successor}, unordered neighbours when symmetric
+  std::vector<std::array<int, 2>> links (v_count, {-1, -1});
+  std::vector<int>                fragment (v_count);
+  std::iota(fragment.begin(), fragment.end(), 0);
+
+  const auto find {[&fragment](int v) noexcept {
+    while (fragment[v] != v) {
+      fragment[v] = fragment[fragment[v]];
+      v           = fragment[v];
+    }
+    return v;
+  }};
+
+  int added {0};
+  for (const Edge& edge : edges) {
+    if (added == v_count - 1) {
+      break;
+    }
+
+    const bool from_free {links[edge.from][1] == -1};
+    const bool to_free {symmetric ? links[edge.to][1] == -1
+                                  : links[edge.to][0] == -1};
+    if (!from_free || !to_free || find(edge.from) == find(edge.to)) {
+      continue;
+    }
+
+    if (symmetric) {
+      links[edge.from][links[edge.from][0] == -1 ? 0 : 1] = edge.to;
+      links[edge.to][links[edge.to][0] == -1 ? 0 : 1]     = edge.from;
+    } else {
+      links[edge.from][1] = edge.to;
+      links[edge.to][0]   = edge.from;
+    }
+    fragment[find(edge.from)] = find(edge.to);
+    ++added;
+  }
+
+  if (added != v_count - 1) [[unlikely]] {
+    return std::nullopt;
+  }
+
+  // walk the single fragment from one of its ends
+  int start {0};
+  for (int v {0}; v < v_count; ++v) {
+    if (symmetric ? links[v][1] == -1 : links[v][0] == -1) {
+      start = v;
+      break;
+    }
+  }
+
+  std::vector<int> path {};
+  path.reserve(v_count + 1);
+  for (int previous {-1}, current {start}; current != -1;) {
+    path.push_back(current);
+    const int next {!symmetric ? links[current][1]
+                    : links[current][0] != previous ? links[current][0]
+                                                    : links[current][1]};
+    previous = current;
+    current  = next;
+  }
+
+  return close(matrix, std::move(path));
+}
+
+std::optional<tsp::Solution> farthest_insertion(
+const tsp::CostMatrix& matrix) noexcept {
+  const int v_count {static_cast<int>(matrix.size())};
+
+  // successor[v] on the tour, -1 while v is off it, distance[v] to the
+  // nearest tour vertex, -1 while no edge joins them (taken last)
+  std::vector<int> successor (v_count, -1);
+  std::vector<int> distance (v_count, -1);
+
+  successor[0] = 0;
+  for (int v {1}; v < v_count; ++v) {
+    distance[v] = weight(matrix, 0, v);
+  }
+
+  for (int placed {1}; placed < v_count; ++placed) {
+    int farthest {-1};
+    for (int v {0}; v < v_count; ++v) {
+      if (successor[v] == -1 &&
+          (farthest == -1 || distance[v] > distance[farthest])) {
+        farthest = v;
+      }
+    }
+
+    // cheapest tour edge to break, both new edges have to exist
+    int after {-1};
+    int after_delta {std::numeric_limits<int>::max()};
+    int from {0};
+    do {
+      const int to {successor[from]};
+      const int in {edge(matrix, from, farthest)};
+      const int out {edge(matrix, farthest, to)};
+      if (in != -1 && out != -1) {
+        const int delta {in + out - edge(matrix, from, to)};
+        if (delta < after_delta) {
+          after       = from;
+          after_delta = delta;
+        }
+      }
+      from = to;
+    } while (from != 0);
+
+    if (after == -1) [[unlikely]] {
+      return std::nullopt;
+    }
+
+    successor[farthest] = successor[after];
+    successor[after]    = farthest;
+
+    for (int v {0}; v < v_count; ++v) {
+      const int to_farthest {weight(matrix, farthest, v)};
+      if (successor[v] == -1 && to_farthest != -1 &&
+          (distance[v] == -1 || to_farthest < distance[v])) {
+        distance[v] = to_farthest;
+      }
+    }
+  }
+
+  std::vector<int> path {};
+  path.reserve(v_count + 1);
+  int current {0};
+  do {
+    path.push_back(current);
+    current = successor[current];
+  } while (current != 0);
+
+  return close(matrix, std::move(path));
+}
+
+std::optional<tsp::Solution> mst_walk(const tsp::CostMatrix& matrix) noexcept {
+  const int v_count {static_cast<int>(matrix.size())};
+
+  // prim on the dense matrix, key[v] is the cheapest edge into the tree
+  std::vector<int>  parent (v_count, -1);
+  std::vector<int>  key (v_count, std::numeric_limits<int>::max());
+  std::vector<char> in_tree (v_count, 0);
+  key[0] = 0;
+
+  for (int added {0}; added < v_count; ++added) {
+    int next {-1};
+    for (int v {0}; v < v_count; ++v) {
+      if (in_tree[v] == 0 && key[v] != std::numeric_limits<int>::max() &&
+          (next == -1 || key[v] < key[next])) {
+        next = v;
+      }
+    }
+    if (next == -1) [[unlikely]] {    // graph not connected
+      return std::nullopt;
+    }
+
+    in_tree[next] = 1;
+    for (int v {0}; v < v_count; ++v) {
+      const int to_next {weight(matrix, next, v)};
+      if (in_tree[v] == 0 && to_next != -1 && to_next < key[v]) {
+        key[v]    = to_next;
+        parent[v] = next;
+      }
+    }
+  }
+
+  // children of every vertex in ascending order, children[first_child[v]]
+  // to children[first_child[v + 1]]
+  std::vector<int> first_child (v_count + 1, 0);
+  for (int v {1}; v < v_count; ++v) {
+    ++first_child[parent[v] + 1];
+  }
+  std::partial_sum(first_child.begin(), first_child.end(), first_child.begin());
+
+  std::vector<int> children (std::max(v_count - 1, 0));
+  std::vector<int> cursor (first_child.begin(), first_child.end() - 1);
+  for (int v {1}; v < v_count; ++v) {
+    children[cursor[parent[v]]++] = v;
+  }
+
+  // preorder, children pushed in reverse so the lower one is visited first
+  std::vector<int> path {};
+  path.reserve(v_count + 1);
+  std::vector<int> stack {0};
+  while (!stack.empty()) {
+    const int v {stack.back()};
+    stack.pop_back();
+    path.push_back(v);
+    for (int i {first_child[v + 1] - 1}; i >= first_child[v]; --i) {
+      stack.push_back(children[i]);
+    }
+  }
+
+  return close(matrix, std::move(path));
+}
+
+std::variant<tsp::Solution, tsp::ErrorAlgorithm> tour(
+const tsp::CostMatrix&    matrix,
+const tsp::GraphInfo&     graph_info,
+const std::optional<int>& optimal_cost,
+const tsp::Construction   construction) noexcept {
+  std::optional<tsp::Solution> built {};
+  switch (construction) {
+    case tsp::Construction::NEAREST_NEIGHBOUR:
+      break;
+    case tsp::Construction::GREEDY:
+      built = greedy_edge(matrix, graph_info.symmetric_graph);
+      break;
+    case tsp::Construction::INSERTION:
+      built = farthest_insertion(matrix);
+      break;
+    case tsp::Construction::MST:
+      built = mst_walk(matrix);
+      break;
+  }
+
+  if (built.has_value()) {
+    return std::move(*built);
+  }
+  return nn::run(matrix, graph_info, optimal_cost, nn::SINGLE_PATH);
+}
+
+}    // namespace util::construct
@@ -0,0 +1,443 @@
+#include "local_search.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace util::local_search {
+
+Engine::Engine(const tsp::CostMatrix&   matrix,
+               const neighbours::Lists& candidates,
+               const bool               symmetric) noexcept:
+  matrix {matrix},
+  candidates {candidates},
+  symmetric {symmetric},
+  v_count {static_cast<int>(matrix.size())},
+  active(matrix.size(), 0),
+  queue(matrix.size()),
+  solution_positions(matrix.size()) {
+}
+
+int Engine::two_opt(const std::span<int> path,
+                    const std::span<int> positions,
+                    int&                 cost,
+                    const int            max_moves) noexcept {
+  return run(path, positions, cost, max_moves, [this](int vertex) noexcept {
+    return improve_two_opt(vertex);
+  });
+}
+
+int Engine::or_opt(const std::span<int> path,
+                   const std::span<int> positions,
+                   int&                 cost,
+                   const int            max_moves) noexcept {
+  return run(path, positions, cost, max_moves, [this](int vertex) noexcept {
+    return improve_or_opt(vertex);
+  });
+}
+
+int Engine::three_opt(const std::span<int> path,
+                      const std::span<int> positions,
+                      int&                 cost,
+                      const int            max_moves) noexcept {
+  return run(path, positions, cost, max_moves, [this](int vertex) noexcept {
+    return improve_three_opt(vertex);
+  });
+}
+
+int Engine::all(const std::span<int> path,
+                const std::span<int> positions,
+                int&                 cost,
+                const int            max_moves) noexcept {
+  return run(path, positions, cost, max_moves, [this](int vertex) noexcept {
+    return improve_two_opt(vertex) || improve_or_opt(vertex) ||
+           improve_three_opt(vertex);
+  });
+}
+
+int Engine::improve(const tsp::LocalSearch kind,
+                    const std::span<int>   path,
+                    const std::span<int>   positions,
+                    int&                   cost,
+                    const int              max_moves) noexcept {
+  switch (kind) {
+    case tsp::LocalSearch::NONE:
+      return 0;
+    case tsp::LocalSearch::TWO_OPT:
+      return two_opt(path, positions, cost, max_moves);
+    case tsp::LocalSearch::OR_OPT:
+      return or_opt(path, positions, cost, max_moves);
+    case tsp::LocalSearch::THREE_OPT:
+      return three_opt(path, positions, cost, max_moves);
+    case tsp::LocalSearch::ALL:
+      return all(path, positions, cost, max_moves);
+  }
+  return 0;
+}
+
+int Engine::improve(const tsp::LocalSearch kind,
+                    tsp::Solution&         solution,
+                    const int              max_moves) noexcept {
+  for (int i {0}; i < v_count; ++i) {
+    solution_positions[solution.path[i]] = i;
+  }
+  return improve(
+  kind, solution.path, solution_positions, solution.cost, max_moves);
+}
+
+template<typename Improve>
+int Engine::run(const std::span<int> path_in,
+                const std::span<int> positions_in,
+                int&                 cost,
+                const int            max_moves,
+                Improve&&            improve) noexcept {
+  // too small for any move that changes the tour
+  if (v_count < 5 || candidates.empty()) [[unlikely]] {
+    return 0;
+  }
+
+  path       = path_in;
+  positions  = positions_in;
+  delta_sum  = 0;
+  queue_head = 0;
+  queue_size = 0;
+  std::ranges::fill(active, 0);
+  for (int i {0}; i < v_count; ++i) {
+    activate(path[i]);
+  }
+
+  int moves {0};
+  while (queue_size != 0 && (max_moves == 0 || moves < max_moves)) {
+    const int vertex {queue[queue_head]};
+    queue_head = (queue_head + 1) % queue.size();
+    --queue_size;
+    active[vertex] = 0;
+
+    if (improve(vertex)) {
+      ++moves;
+      activate(vertex);
+    }
+  }
+
+  path[v_count]  = path[0];
+  cost          += delta_sum;
+  return moves;
+}
+
+void Engine::activate(const int vertex) noexcept {
+  if (active[vertex] != 0) {
+    return;
+  }
+  active[vertex]                                     = 1;
+  queue[(queue_head + queue_size) % queue.size()] = vertex;
+  ++queue_size;
+}
+
+// tour ... a b ... c d ... becomes ... a c ... b d ..., and on symmetric
+// instances also ... d c ... b a ... becomes ... d b ... c a ...
+bool Engine::improve_two_opt(const int a) noexcept {
+  for (const bool forward : {true, false}) {
+    if (!forward && !symmetric) {
+      break;
+    }
+
+    const int b {forward ? next(a) : prev(a)};
+    const int ab_cost {forward ? matrix(a, b) : matrix(b, a)};
+
+    for (const int c : candidates.of(a)) {
+      const int ac_cost {matrix(a, c)};
+      // the new edge at a has to be cheaper than the removed one
+      if (ac_cost >= ab_cost) {
+        break;
+      }
+
+      const int d {forward ? next(c) : prev(c)};
+      if (c == b || d == a) {
+        continue;
+      }
+
+      const int bd_cost {forward ? matrix(b, d) : matrix(d, b)};
+      if (bd_cost == -1) {
+        continue;
+      }
+
+      const int from {forward ? positions[b] : positions[a]};
+      const int to {forward ? positions[c] : positions[d]};
+
+      int delta {ac_cost + bd_cost - ab_cost -
+                 (forward ? matrix(c, d) : matrix(d, c))};
+      if (!symmetric) {
+        const std::optional<int> inner {reversal_delta(from, to)};
+        if (!inner.has_value()) {
+          continue;
+        }
+        delta += *inner;
+      }
+
+      if (delta < 0) {
+        reverse(from, to);
+        delta_sum += delta;
+        activate(b);
+        activate(c);
+        activate(d);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// segment s ... e starting at the vertex goes between c and its successor,
+// on symmetric instances also reversed
+bool Engine::improve_or_opt(const int first) noexcept {
+  for (int length {1};
+       length <= OR_OPT_MAX_LENGTH && length < v_count - 2;
+       ++length) {
+    const int start {positions[first]};
+    // segments crossing the end of the path are left out
+    if (start + length > v_count) {
+      break;
+    }
+
+    const int last {path[start + length - 1]};
+    const int before {prev(first)};
+    const int after {next(last)};
+
+    const int bridge_cost {matrix(before, after)};
+    if (bridge_cost == -1) {
+      continue;
+    }
+
+    const int removal_gain {matrix(before, first) + matrix(last, after) -
+                            bridge_cost};
+    if (removal_gain <= 0) {
+      continue;
+    }
+
+    const auto in_segment {[&](int vertex) noexcept {
+      return (positions[vertex] - start + v_count) % v_count < length;
+    }};
+
+    for (const bool reversed : {false, true}) {
+      if (reversed && (!symmetric || length == 1)) {
+        break;
+      }
+
+      // the vertex entered after c is first, or last when reversed
+      const int head {reversed ? last : first};
+      const int tail {reversed ? first : last};
+
+      for (const int e : candidates.of(tail)) {
+        const int c {prev(e)};
+        if (in_segment(e) || in_segment(c) || c == before) {
+          continue;
+        }
+
+        const int ch_cost {matrix(c, head)};
+        const int te_cost {matrix(tail, e)};
+        if (ch_cost == -1 || te_cost == -1) {
+          continue;
+        }
+
+        const int delta {ch_cost + te_cost - matrix(c, e) - removal_gain};
+        if (delta < 0) {
+          move_segment(start, length, positions[c]);
+          if (reversed) {
+            reverse(positions[first], positions[last]);
+          }
+          delta_sum += delta;
+          activate(before);
+          activate(after);
+          activate(last);
+          activate(c);
+          activate(e);
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+// tour a b ... c d ... e f becomes a d ... e b ... c f, the new edges a d
+// and c f come from the neighbour lists and every partial gain has to stay
+// positive, e b closes the move, on symmetric instances the tour is also
+// read backwards
+bool Engine::improve_three_opt(const int a) noexcept {
+  for (const bool forward : {true, false}) {
+    if (!forward && !symmetric) {
+      break;
+    }
+
+    // steps along the reading direction, costs need no mirroring as the
+    // backward reading is only used on symmetric instances
+    const auto after {[&](int vertex) noexcept {
+      return forward ? next(vertex) : prev(vertex);
+    }};
+    const auto before {[&](int vertex) noexcept {
+      return forward ? prev(vertex) : next(vertex);
+    }};
+    const auto offset {[&](int vertex) noexcept {
+      const int steps {positions[vertex] - positions[a]};
+      return ((forward ? steps : -steps) + v_count) % v_count;
+    }};
+
+    const int b {after(a)};
+    const int ab_cost {matrix(a, b)};
+
+    for (const int d : candidates.of(a)) {
+      const int ad_gain {ab_cost - matrix(a, d)};
+      if (ad_gain <= 0) {
+        break;
+      }
+
+      // the moved segment b ... c is not empty
+      const int d_offset {offset(d)};
+      if (d_offset < 2) {
+        continue;
+      }
+
+      const int c {before(d)};
+      const int cd_cost {matrix(c, d)};
+
+      for (const int f : candidates.of(c)) {
+        const int cf_gain {ad_gain + cd_cost - matrix(c, f)};
+        if (cf_gain <= 0) {
+          break;
+        }
+
+        // f after d, a itself closes the tour
+        const int f_offset {f == a ? v_count : offset(f)};
+        if (f_offset <= d_offset) {
+          continue;
+        }
+
+        const int e {before(f)};
+        const int eb_cost {matrix(e, b)};
+        if (eb_cost == -1) {
+          continue;
+        }
+
+        const int delta {eb_cost - matrix(e, f) - cf_gain};
+        if (delta < 0) {
+          const int bc_length {d_offset - 1};
+          const int de_length {f_offset - d_offset};
+          if (forward) {
+            swap_blocks(positions[b], bc_length, de_length);
+          } else {
+            swap_blocks(positions[e], de_length, bc_length);
+          }
+          delta_sum += delta;
+          activate(b);
+          activate(c);
+          activate(d);
+          activate(e);
+          activate(f);
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+std::optional<int> Engine::reversal_delta(const int from,
+                                          const int to) const noexcept {
+  const int length {(to - from + v_count) % v_count + 1};
+
+  int delta {0};
+  for (int step {0}; step < length - 1; ++step) {
+    const int u {path[(from + step) % v_count]};
+    const int v {path[(from + step + 1) % v_count]};
+    const int reversed_cost {matrix(v, u)};
+    if (reversed_cost == -1) {
+      return std::nullopt;
+    }
+    delta += reversed_cost - matrix(u, v);
+  }
+  return delta;
+}
+
+// positions from .. to going forward, on symmetric instances the shorter of
+// the segment and its complement is reversed
+void Engine::reverse(int from, int to) noexcept {
+  int length {(to - from + v_count) % v_count + 1};
+
+  if (symmetric && 2 * length > v_count) {
+    std::tie(from, to) = std::pair {(to + 1) % v_count,
+                                    (from + v_count - 1) % v_count};
+    length             = v_count - length;
+  }
+
+  flip(from, length);
+}
+
+// exact reversal of length positions starting at from, wrapping around
+void Engine::flip(const int from, const int length) noexcept {
+  for (int step {0}; step < length / 2; ++step) {
+    const int left {(from + step) % v_count};
+    const int right {(from + length - 1 - step) % v_count};
+    std::swap(path[left], path[right]);
+    positions[path[left]]  = left;
+    positions[path[right]] = right;
+  }
+}
+
+// the block of first_length positions at from and the block following it
+// change places, the tour is a cycle so swapping either of the other two
+// pairs of neighbouring blocks gives the same tour and the cheapest is taken
+void Engine::swap_blocks(int from,
+                         int first_length,
+                         int second_length) noexcept {
+  const int rest_length {v_count - first_length - second_length};
+
+  if (rest_length + first_length < first_length + second_length &&
+      rest_length + first_length <= second_length + rest_length) {
+    // rest, first
+    std::tie(from, first_length, second_length) = std::tuple {
+      (from + first_length + second_length) % v_count,
+      rest_length,
+      first_length};
+  } else if (second_length + rest_length < first_length + second_length) {
+    // second, rest
+    std::tie(from, first_length, second_length) = std::tuple {
+      (from + first_length) % v_count, second_length, rest_length};
+  }
+
+  flip(from, first_length + second_length);
+  flip(from, second_length);
+  flip((from + second_length) % v_count, first_length);
+}
+
+// segment [from, from + length) goes behind position after, the segment does
+// not cross the end of the path
+void Engine::move_segment(const int from,
+                          const int length,
+                          const int after) noexcept {
+  const auto base {path.begin()};
+
+  int low {0};
+  int high {0};
+  if (after > from) {
+    std::rotate(base + from, base + from + length, base + after + 1);
+    low  = from;
+    high = after;
+  } else {
+    std::rotate(base + after + 1, base + from, base + from + length);
+    low  = after + 1;
+    high = from + length - 1;
+  }
+
+  for (int i {low}; i <= high; ++i) {
+    positions[path[i]] = i;
+  }
+}
+
+}    // namespace util::local_search
@@ -11,9 +11,11 @@
   #include "zadanie_2/bxb_bfs.hpp"
   #include "zadanie_2/bxb_dfs.hpp"
   #include "zadanie_2/bxb_lc.hpp"
+  #include "zadanie_2/hk.hpp"
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
+  #include "zadanie_3/ls.hpp"
   #include "zadanie_3/ts.hpp"
 #endif
 
@@ -24,6 +26,7 @@
 #include <cstdlib>
 #include <optional>
 #include <variant>
+#include <vector>
 #include <windows.h>
 
 #pragma comment(lib, "Kernel32.lib")
@@ -59,11 +62,19 @@ int main(int argc, const char** argv) {
   }
   const tsp::Instance config {std::get<tsp::Instance>(config_result)};
 
+  // seed from the command line, else from the config, else a random one
+  util::rng::set_seed(std::get<tsp::SingleRun>(arg).seed.value_or(
+  config.seed.value_or(util::rng::random_seed())));
+
   const std::optional optimal_cost {config.optimal.cost != -1
                                     ? std::optional {config.optimal.cost}
                                     : std::nullopt};
 
-  const auto timed_result {[&arg, &config, &optimal_cost]() noexcept {
+  // per worker statistics of the algorithms that keep them
+  std::vector<tsp::ThreadStats> thread_stats {};
+
+  const auto timed_result {[&arg, &config, &optimal_cost, &thread_stats](
+                           ) noexcept {
     switch (std::get<tsp::SingleRun>(arg).algorithm) {
 #if defined(ZADANIE1) && ZADANIE1 == 1
       case tsp::Algorithm::BRUTE_FORCE:
@@ -75,7 +86,8 @@ int main(int argc, const char** argv) {
         return util::measured_run(nn::run,
                                   config.matrix,
                                   config.graph_info,
-                                  optimal_cost);
+                                  optimal_cost,
+                                  config.params.nearest_neighbour.beam);
       case tsp::Algorithm::RANDOM:
         return util::measured_run(random::run,
                                   config.matrix,
@@ -89,32 +101,65 @@ int main(int argc, const char** argv) {
         return util::measured_run(bxb::lc::run,
                                   config.matrix,
                                   config.graph_info,
-                                  optimal_cost);
+                                  optimal_cost,
+                                  config.params.branch_and_bound.initial,
+                                  &thread_stats);
       case tsp::Algorithm::BXB_BFS:
         return util::measured_run(bxb::bfs::run,
                                   config.matrix,
                                   config.graph_info,
-                                  optimal_cost);
+                                  optimal_cost,
+                                  config.params.branch_and_bound.initial);
       case tsp::Algorithm::BXB_DFS:
         return util::measured_run(bxb::dfs::run,
+                                  config.matrix,
+                                  config.graph_info,
+                                  optimal_cost,
+                                  config.params.branch_and_bound.initial);
+      case tsp::Algorithm::HELD_KARP:
+        return util::measured_run(hk::run,
                                   config.matrix,
                                   config.graph_info,
                                   optimal_cost);
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
-      case tsp::Algorithm::TABU_SEARCH:
+      case tsp::Algorithm::TABU_SEARCH: {
+        const util::neighbours::Lists neighbours {
+          config.matrix,
+          ts::neighbour_width(config.params.tabu_search.candidates,
+                              config.params.tabu_search.local_search)};
         return util::measured_run(ts::run,
                                   config.matrix,
                                   config.graph_info,
                                   optimal_cost,
                                   config.params.tabu_search.itr,
                                   config.params.tabu_search.max_itr_no_improve,
-                                  config.params.tabu_search.tabu_itr);
+                                  config.params.tabu_search.tabu_itr,
+                                  config.params.tabu_search.neighbourhood,
+                                  config.params.tabu_search.candidates,
+                                  neighbours,
+                                  config.params.tabu_search.threads,
+                                  config.params.tabu_search.starts,
+                                  config.params.tabu_search.local_search,
+                                  config.params.tabu_search.initial,
+                                  config.params.tabu_search.millis);
+      }
+      case tsp::Algorithm::LOCAL_SEARCH:
+        return util::measured_run(ls::run,
+                                  config.matrix,
+                                  config.graph_info,
+                                  optimal_cost,
+                                  config.params.local_search.method,
+                                  config.params.local_search.candidates,
+                                  config.params.local_search.initial);
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
-      case tsp::Algorithm::GENETIC:
+      case tsp::Algorithm::GENETIC: {
+        const util::neighbours::Lists neighbours {
+          config.matrix,
+          gen::neighbour_width(config.params.genetic.local_search)};
         return util::measured_run(gen::run,
                                   config.matrix,
                                   config.graph_info,
@@ -124,7 +169,17 @@ int main(int argc, const char** argv) {
                                   config.params.genetic.children_per_itr,
                                   config.params.genetic.max_children_per_pair,
                                   config.params.genetic.max_v_count_crossover,
-                                  config.params.genetic.mutations_per_1000);
+                                  config.params.genetic.mutations_per_1000,
+                                  config.params.genetic.crossover,
+                                  config.params.genetic.local_search,
+                                  config.params.genetic.local_search_moves,
+                                  neighbours,
+                                  config.params.genetic.islands,
+                                  config.params.genetic.migration_interval,
+                                  config.params.genetic.migrants,
+                                  config.params.genetic.initial,
+                                  config.params.genetic.millis);
+      }
 #endif
       default:
         std::exit(1);
@@ -135,7 +190,8 @@ int main(int argc, const char** argv) {
   }
   const tsp::Result timed {std::get<tsp::Result>(timed_result)};
 
-  util::output::report(std::get<tsp::SingleRun>(arg), config, timed);
+  util::output::report(
+  std::get<tsp::SingleRun>(arg), config, timed, thread_stats);
 
   return EXIT_SUCCESS;
 }
@@ -10,9 +10,11 @@
   #include "zadanie_2/bxb_bfs.hpp"
   #include "zadanie_2/bxb_dfs.hpp"
   #include "zadanie_2/bxb_lc.hpp"
+  #include "zadanie_2/hk.hpp"
 #endif
 
 #if (defined(ZADANIE3) && ZADANIE3 == 1)
+  #include "zadanie_3/ls.hpp"
   #include "zadanie_3/ts.hpp"
 #endif
 
@@ -24,10 +26,20 @@
 
 namespace util::measure {
 
+#if (defined(ZADANIE3) && ZADANIE3 == 1) || (defined(ZADANIE4) && ZADANIE4 == 1)
+// empty when the run never got within the target of the optimum
+static std::string time_to_target_us(const tsp::Result& run) noexcept {
+  if (!run.time_to_target.has_value()) {
+    return "";
+  }
+  return fmt::format("{:.2f}", run.time_to_target->count() * 1000.);
+}
+#endif
+
 #if (defined(ZADANIE1) && ZADANIE1 == 1) || (defined(ZADANIE2) && ZADANIE2 == 1)
 template<typename AlgoRun, typename... Params>
 requires std::invocable<AlgoRun,
-                        const tsp::Matrix<int>&,
+                        const tsp::CostMatrix&,
                         const tsp::GraphInfo&,
                         const std::optional<int>&,
                         Params...>
@@ -47,7 +59,7 @@ Params... algo_params) noexcept {
   }
 
   file_s
-  << "Ilosc wierzcholkow;Nazwa;Koszt optymalny;Koszt obliczony;Czas [us]\n";
+  << "Ilosc wierzcholkow;Nazwa;Koszt optymalny;Koszt obliczony;Czas [us];Ziarno\n";
 
   for (int s {5}; s < std::min(20, max_v); ++s) {
     if (verbose) {
@@ -111,12 +123,13 @@ Params... algo_params) noexcept {
       const std::string time_us {
         fmt::format("{:.2f}", run.time.count() * 1000.)};
 
-      file_s << fmt::format("{};{};{};{};{}\n",
+      file_s << fmt::format("{};{};{};{};{};{}\n",
                             v_count,
                             instance_name,
                             optimal_cost,
                             cost,
-                            time_us);
+                            time_us,
+                            run.seed);
     }
   }
 
@@ -125,7 +138,7 @@ Params... algo_params) noexcept {
 
 template<typename AlgoRun, typename... Params>
 requires std::invocable<AlgoRun,
-                        const tsp::Matrix<int>&,
+                        const tsp::CostMatrix&,
                         const tsp::GraphInfo&,
                         const std::optional<int>&,
                         Params...>
@@ -145,7 +158,7 @@ Params... algo_params) noexcept {
   }
 
   file_as
-  << "Ilosc wierzcholkow;Nazwa;Koszt optymalny;Koszt obliczony;Czas [us]\n";
+  << "Ilosc wierzcholkow;Nazwa;Koszt optymalny;Koszt obliczony;Czas [us];Ziarno\n";
 
   for (int s {5}; s < std::min(19, max_v); ++s) {
     if (verbose) {
@@ -209,12 +222,13 @@ Params... algo_params) noexcept {
       const std::string time_us {
         fmt::format("{:.2f}", run.time.count() * 1000.)};
 
-      file_as << fmt::format("{};{};{};{};{}\n",
+      file_as << fmt::format("{};{};{};{};{};{}\n",
                              v_count,
                              instance_name,
                              optimal_cost,
                              cost,
-                             time_us);
+                             time_us,
+                             run.seed);
     }
   }
 
@@ -224,12 +238,20 @@ Params... algo_params) noexcept {
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
 struct Z3MeasureInstance {
-  std::filesystem::path name;
-  tsp::Matrix<int>      matrix;
-  tsp::GraphInfo        graph_info;
-  std::optional<int>    optimal_cost;
-  std::optional<int>    calc_tabu_itr;
-  std::optional<int>    calc_itr;
+  std::filesystem::path   name;
+  tsp::CostMatrix         matrix;
+  tsp::GraphInfo          graph_info;
+  std::optional<int>      optimal_cost;
+  std::optional<int>      calc_tabu_itr;
+  std::optional<int>      calc_itr;
+  tsp::Neighbourhood      neighbourhood;
+  int                     candidates;
+  util::neighbours::Lists neighbours;    // built once, shared by all runs
+  int                     threads;
+  int                     starts;
+  tsp::LocalSearch        local_search;
+  tsp::Construction       initial;
+  int                     millis;
 };
 
 template<typename Itr>
@@ -253,7 +275,7 @@ requires std::forward_iterator<Itr> &&
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji w tabu;Ilosc iteracji;Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji w tabu;Ilosc iteracji;Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     double last_percent {100.};
@@ -275,7 +297,15 @@ requires std::forward_iterator<Itr> &&
                                   it->optimal_cost,
                                   i,
                                   i,
-                                  *it->calc_tabu_itr)};
+                                  *it->calc_tabu_itr,
+                                  it->neighbourhood,
+                                  it->candidates,
+                                  it->neighbours,
+                                  it->threads,
+                                  it->starts,
+                                  it->local_search,
+                                  it->initial,
+                                  it->millis)};
         if (error::handle(result) == tsp::State::ERROR) {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -293,7 +323,15 @@ requires std::forward_iterator<Itr> &&
                                    it->optimal_cost,
                                    i,
                                    i,
-                                   *it->calc_tabu_itr)};
+                                   *it->calc_tabu_itr,
+                                   it->neighbourhood,
+                                   it->candidates,
+                                   it->neighbours,
+                                   it->threads,
+                                   it->starts,
+                                   it->local_search,
+                                   it->initial,
+                                   it->millis)};
         if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -325,7 +363,7 @@ requires std::forward_iterator<Itr> &&
         const std::string time_us {
           fmt::format("{:.2f}", run.time.count() * 1000.)};
 
-        file << fmt::format("{};{};{};{};{};{};{};{:.2f}\n",
+        file << fmt::format("{};{};{};{};{};{};{};{:.2f};{};{}\n",
                             v_count,
                             instance_name,
                             optimal_cost,
@@ -333,7 +371,9 @@ requires std::forward_iterator<Itr> &&
                             tabu_itr,
                             i,
                             time_us,
-                            error_percent);
+                            error_percent,
+                            time_to_target_us(run),
+                            run.seed);
       }
     }
   }
@@ -363,7 +403,7 @@ requires std::forward_iterator<Itr> &&
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji w tabu;Ilosc iteracji;Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji w tabu;Ilosc iteracji;Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     double last_percent {100.};
@@ -385,7 +425,15 @@ requires std::forward_iterator<Itr> &&
                                   it->optimal_cost,
                                   itr,
                                   itr,
-                                  i)};
+                                  i,
+                                  it->neighbourhood,
+                                  it->candidates,
+                                  it->neighbours,
+                                  it->threads,
+                                  it->starts,
+                                  it->local_search,
+                                  it->initial,
+                                  it->millis)};
         if (error::handle(result) == tsp::State::ERROR) {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -403,7 +451,15 @@ requires std::forward_iterator<Itr> &&
                                    it->optimal_cost,
                                    itr,
                                    itr,
-                                   i)};
+                                   i,
+                                   it->neighbourhood,
+                                   it->candidates,
+                                   it->neighbours,
+                                   it->threads,
+                                   it->starts,
+                                   it->local_search,
+                                   it->initial,
+                                   it->millis)};
         if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -435,7 +491,7 @@ requires std::forward_iterator<Itr> &&
         const std::string time_us {
           fmt::format("{:.2f}", run.time.count() * 1000.)};
 
-        file << fmt::format("{};{};{};{};{};{};{};{:.2f}\n",
+        file << fmt::format("{};{};{};{};{};{};{};{:.2f};{};{}\n",
                             v_count,
                             instance_name,
                             optimal_cost,
@@ -443,7 +499,9 @@ requires std::forward_iterator<Itr> &&
                             tabu_itr,
                             itr,
                             time_us,
-                            error_percent);
+                            error_percent,
+                            time_to_target_us(run),
+                            run.seed);
       }
     }
   }
@@ -470,7 +528,7 @@ requires std::forward_iterator<Itr> &&
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji w tabu;Ilosc iteracji;Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji w tabu;Ilosc iteracji;Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     if (verbose) {
@@ -489,7 +547,15 @@ requires std::forward_iterator<Itr> &&
                                 it->optimal_cost,
                                 itr,
                                 itr,
-                                *it->calc_tabu_itr)};
+                                *it->calc_tabu_itr,
+                                it->neighbourhood,
+                                it->candidates,
+                                it->neighbours,
+                                it->threads,
+                                it->starts,
+                                it->local_search,
+                                it->initial,
+                                it->millis)};
       if (error::handle(result) == tsp::State::ERROR) {
         return tsp::ErrorMeasure::ALGORITHM_ERROR;
       }
@@ -507,7 +573,15 @@ requires std::forward_iterator<Itr> &&
                                  it->optimal_cost,
                                  itr,
                                  itr,
-                                 *it->calc_tabu_itr)};
+                                 *it->calc_tabu_itr,
+                                 it->neighbourhood,
+                                 it->candidates,
+                                 it->neighbours,
+                                 it->threads,
+                                 it->starts,
+                                 it->local_search,
+                                 it->initial,
+                                 it->millis)};
       if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
         return tsp::ErrorMeasure::ALGORITHM_ERROR;
       }
@@ -534,7 +608,7 @@ requires std::forward_iterator<Itr> &&
       const std::string time_us {
         fmt::format("{:.2f}", run.time.count() * 1000.)};
 
-      file << fmt::format("{};{};{};{};{};{};{};{:.2f}\n",
+      file << fmt::format("{};{};{};{};{};{};{};{:.2f};{};{}\n",
                           v_count,
                           instance_name,
                           optimal_cost,
@@ -542,7 +616,9 @@ requires std::forward_iterator<Itr> &&
                           tabu_itr,
                           itr,
                           time_us,
-                          error_percent);
+                          error_percent,
+                          time_to_target_us(run),
+                          run.seed);
     }
   }
 
@@ -581,6 +657,17 @@ const char* out_n) noexcept {
     instances.at(i).optimal_cost  = it->optimal.cost;
     instances.at(i).calc_tabu_itr = std::nullopt;
     instances.at(i).calc_itr      = std::nullopt;
+    instances.at(i).neighbourhood = it->params.tabu_search.neighbourhood;
+    instances.at(i).candidates    = it->params.tabu_search.candidates;
+    instances.at(i).threads       = it->params.tabu_search.threads;
+    instances.at(i).starts        = it->params.tabu_search.starts;
+    instances.at(i).local_search  = it->params.tabu_search.local_search;
+    instances.at(i).initial       = it->params.tabu_search.initial;
+    instances.at(i).millis        = it->params.tabu_search.millis;
+    instances.at(i).neighbours    = util::neighbours::Lists {
+      instances.at(i).matrix,
+      ts::neighbour_width(instances.at(i).candidates,
+                          instances.at(i).local_search)};
 
     ++i;
   }
@@ -616,19 +703,133 @@ const char* out_n) noexcept {
 
   return err;
 }
+
+// every neighbourhood of the local search engine on every instance, the
+// starting tour and the candidate lists come from the instance config
+template<typename Itr>
+requires std::forward_iterator<Itr> &&
+         std::is_same_v<
+         std::remove_cvref_t<typename std::iterator_traits<Itr>::value_type>,
+         tsp::Instance>
+static std::optional<tsp::ErrorMeasure> z3_measure_local_search(
+Itr         begin,
+Itr         end,
+bool        verbose,
+const char* out) noexcept {
+  constexpr static std::array methods {
+    std::pair {tsp::LocalSearch::TWO_OPT,   "2opt"},
+    std::pair {tsp::LocalSearch::OR_OPT,    "oropt"},
+    std::pair {tsp::LocalSearch::THREE_OPT, "3opt"},
+    std::pair {tsp::LocalSearch::ALL,       "all"},
+  };
+
+  std::ofstream file {out};
+
+  if (!file.is_open()) {
+    return tsp::ErrorMeasure::FILE_ERROR;
+  }
+
+  file
+  << "Ilosc miast;Nazwa;Metoda;Koszt optymalny;Koszt obliczony;Czas [us];Blad [%];Ziarno\n";
+
+  for (Itr it {begin}; it != end; ++it) {
+    const std::optional<int> optimal_cost {it->optimal.cost};
+
+    for (const auto& [method, method_name] : methods) {
+      if (verbose) {
+        fmt::print("Local Search [{:<20}] {:>5}: ",
+                   it->input_file.stem().string(),
+                   method_name);
+      }
+
+      std::array<tsp::Result, 2> cache_runs {};
+      std::array<tsp::Result, 5> runs {};
+
+      for (int j {0}; j < 2; ++j) {
+        auto result {measured_run(ls::run,
+                                  it->matrix,
+                                  it->graph_info,
+                                  optimal_cost,
+                                  method,
+                                  it->params.local_search.candidates,
+                                  it->params.local_search.initial)};
+        if (error::handle(result) == tsp::State::ERROR) {
+          return tsp::ErrorMeasure::ALGORITHM_ERROR;
+        }
+        cache_runs.at(j) = std::move(std::get<tsp::Result>(result));
+      }
+
+      if (verbose) {
+        fmt::print("[");
+      }
+
+      for (int j {0}; j < 5; ++j) {
+        auto result_ {measured_run(ls::run,
+                                   it->matrix,
+                                   it->graph_info,
+                                   optimal_cost,
+                                   method,
+                                   it->params.local_search.candidates,
+                                   it->params.local_search.initial)};
+        if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
+          return tsp::ErrorMeasure::ALGORITHM_ERROR;
+        }
+
+        runs.at(j) = std::move(std::get<tsp::Result>(result_));
+
+        if (verbose) {
+          fmt::print("-");
+        }
+      }
+
+      if (verbose) {
+        fmt::println("]");
+      }
+
+      const std::string instance_name {it->input_file.stem().string()};
+      const int         v_count {static_cast<int>(it->matrix.size())};
+
+      for (const tsp::Result& run : runs) {
+        const std::string time_us {
+          fmt::format("{:.2f}", run.time.count() * 1000.)};
+
+        file << fmt::format("{};{};{};{};{};{};{:.2f};{}\n",
+                            v_count,
+                            instance_name,
+                            method_name,
+                            it->optimal.cost,
+                            run.solution.cost,
+                            time_us,
+                            run.error_info->relative_percent,
+                            run.seed);
+      }
+    }
+  }
+
+  return std::nullopt;
+}
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
 struct Z4MeasureInstance {
-  std::filesystem::path name;
-  tsp::Matrix<int>      matrix;
-  tsp::GraphInfo        graph_info;
-  std::optional<int>    optimal_cost;
-  std::optional<int>    calc_children_per_itr;
-  std::optional<int>    calc_population_size;
-  std::optional<int>    calc_max_children_per_pair;
-  std::optional<int>    calc_max_v_count_crossover;
-  std::optional<int>    calc_mutations_per_1000;
+  std::filesystem::path   name;
+  tsp::CostMatrix         matrix;
+  tsp::GraphInfo          graph_info;
+  std::optional<int>      optimal_cost;
+  std::optional<int>      calc_children_per_itr;
+  std::optional<int>      calc_population_size;
+  std::optional<int>      calc_max_children_per_pair;
+  std::optional<int>      calc_max_v_count_crossover;
+  std::optional<int>      calc_mutations_per_1000;
+  tsp::Crossover          crossover;
+  tsp::LocalSearch        local_search;
+  int                     local_search_moves;
+  util::neighbours::Lists neighbours;    // built once, shared by all runs
+  int                     islands;
+  int                     migration_interval;
+  int                     migrants;
+  tsp::Construction       initial;
+  int                     millis;
 };
 
 template<typename Itr>
@@ -657,7 +858,7 @@ requires std::forward_iterator<Itr> &&
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     double last_percent {100.};
@@ -683,7 +884,16 @@ requires std::forward_iterator<Itr> &&
                                   i,
                                   max_children_per_pair,
                                   max_v_count_crossover,
-                                  mutations_per_1000)};
+                                  mutations_per_1000,
+                                  it->crossover,
+                                  it->local_search,
+                                  it->local_search_moves,
+                                  it->neighbours,
+                                  it->islands,
+                                  it->migration_interval,
+                                  it->migrants,
+                                  it->initial,
+                                  it->millis)};
         if (error::handle(result) == tsp::State::ERROR) {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -704,7 +914,16 @@ requires std::forward_iterator<Itr> &&
                                    i,
                                    max_children_per_pair,
                                    max_v_count_crossover,
-                                   mutations_per_1000)};
+                                   mutations_per_1000,
+                                   it->crossover,
+                                   it->local_search,
+                                   it->local_search_moves,
+                                   it->neighbours,
+                                   it->islands,
+                                   it->migration_interval,
+                                   it->migrants,
+                                   it->initial,
+                                   it->millis)};
         if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -741,7 +960,7 @@ requires std::forward_iterator<Itr> &&
           it->calc_children_per_itr = i;
         }
 
-        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f}\n",
+        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f};{};{}\n",
                             v_count,
                             instance_name,
                             optimal_cost,
@@ -753,7 +972,9 @@ requires std::forward_iterator<Itr> &&
                             v_count_crossover,
                             mutations,
                             time_us,
-                            error_percent);
+                            error_percent,
+                            time_to_target_us(run),
+                            run.seed);
       }
     }
   }
@@ -786,7 +1007,7 @@ requires std::forward_iterator<Itr> &&
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     double last_percent {100.};
@@ -812,7 +1033,16 @@ requires std::forward_iterator<Itr> &&
                                   *it->calc_children_per_itr,
                                   max_children_per_pair,
                                   max_v_count_crossover,
-                                  mutations_per_1000)};
+                                  mutations_per_1000,
+                                  it->crossover,
+                                  it->local_search,
+                                  it->local_search_moves,
+                                  it->neighbours,
+                                  it->islands,
+                                  it->migration_interval,
+                                  it->migrants,
+                                  it->initial,
+                                  it->millis)};
         if (error::handle(result) == tsp::State::ERROR) {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -833,7 +1063,16 @@ requires std::forward_iterator<Itr> &&
                                    *it->calc_children_per_itr,
                                    max_children_per_pair,
                                    max_v_count_crossover,
-                                   mutations_per_1000)};
+                                   mutations_per_1000,
+                                   it->crossover,
+                                   it->local_search,
+                                   it->local_search_moves,
+                                   it->neighbours,
+                                   it->islands,
+                                   it->migration_interval,
+                                   it->migrants,
+                                   it->initial,
+                                   it->millis)};
         if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -870,7 +1109,7 @@ requires std::forward_iterator<Itr> &&
           it->calc_population_size = i;
         }
 
-        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f}\n",
+        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f};{};{}\n",
                             v_count,
                             instance_name,
                             optimal_cost,
@@ -882,7 +1121,9 @@ requires std::forward_iterator<Itr> &&
                             v_count_crossover,
                             mutations,
                             time_us,
-                            error_percent);
+                            error_percent,
+                            time_to_target_us(run),
+                            run.seed);
       }
     }
   }
@@ -914,7 +1155,7 @@ requires std::forward_iterator<Itr> &&
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     double last_percent {100.};
@@ -940,7 +1181,16 @@ requires std::forward_iterator<Itr> &&
                                   *it->calc_children_per_itr,
                                   i,
                                   max_v_count_crossover,
-                                  mutations_per_1000)};
+                                  mutations_per_1000,
+                                  it->crossover,
+                                  it->local_search,
+                                  it->local_search_moves,
+                                  it->neighbours,
+                                  it->islands,
+                                  it->migration_interval,
+                                  it->migrants,
+                                  it->initial,
+                                  it->millis)};
         if (error::handle(result) == tsp::State::ERROR) {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -961,7 +1211,16 @@ requires std::forward_iterator<Itr> &&
                                    *it->calc_children_per_itr,
                                    i,
                                    max_v_count_crossover,
-                                   mutations_per_1000)};
+                                   mutations_per_1000,
+                                   it->crossover,
+                                   it->local_search,
+                                   it->local_search_moves,
+                                   it->neighbours,
+                                   it->islands,
+                                   it->migration_interval,
+                                   it->migrants,
+                                   it->initial,
+                                   it->millis)};
         if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -998,7 +1257,7 @@ requires std::forward_iterator<Itr> &&
           it->calc_max_children_per_pair = i;
         }
 
-        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f}\n",
+        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f};{};{}\n",
                             v_count,
                             instance_name,
                             optimal_cost,
@@ -1010,7 +1269,9 @@ requires std::forward_iterator<Itr> &&
                             v_count_crossover,
                             mutations,
                             time_us,
-                            error_percent);
+                            error_percent,
+                            time_to_target_us(run),
+                            run.seed);
       }
     }
   }
@@ -1041,7 +1302,7 @@ requires std::forward_iterator<Itr> &&
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     double last_percent {100.};
@@ -1067,7 +1328,16 @@ requires std::forward_iterator<Itr> &&
                                   *it->calc_children_per_itr,
                                   *it->calc_max_children_per_pair,
                                   i,
-                                  mutations_per_1000)};
+                                  mutations_per_1000,
+                                  it->crossover,
+                                  it->local_search,
+                                  it->local_search_moves,
+                                  it->neighbours,
+                                  it->islands,
+                                  it->migration_interval,
+                                  it->migrants,
+                                  it->initial,
+                                  it->millis)};
         if (error::handle(result) == tsp::State::ERROR) {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -1088,7 +1358,16 @@ requires std::forward_iterator<Itr> &&
                                    *it->calc_children_per_itr,
                                    *it->calc_max_children_per_pair,
                                    i,
-                                   mutations_per_1000)};
+                                   mutations_per_1000,
+                                   it->crossover,
+                                   it->local_search,
+                                   it->local_search_moves,
+                                   it->neighbours,
+                                   it->islands,
+                                   it->migration_interval,
+                                   it->migrants,
+                                   it->initial,
+                                   it->millis)};
         if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -1125,7 +1404,7 @@ requires std::forward_iterator<Itr> &&
           it->calc_max_v_count_crossover = i;
         }
 
-        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f}\n",
+        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f};{};{}\n",
                             v_count,
                             instance_name,
                             optimal_cost,
@@ -1137,7 +1416,9 @@ requires std::forward_iterator<Itr> &&
                             v_count_crossover,
                             mutations,
                             time_us,
-                            error_percent);
+                            error_percent,
+                            time_to_target_us(run),
+                            run.seed);
       }
     }
   }
@@ -1167,7 +1448,7 @@ requires std::forward_iterator<Itr> &&
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     double last_percent {100.};
@@ -1193,7 +1474,16 @@ requires std::forward_iterator<Itr> &&
                                   *it->calc_children_per_itr,
                                   *it->calc_max_children_per_pair,
                                   *it->calc_max_v_count_crossover,
-                                  i)};
+                                  i,
+                                  it->crossover,
+                                  it->local_search,
+                                  it->local_search_moves,
+                                  it->neighbours,
+                                  it->islands,
+                                  it->migration_interval,
+                                  it->migrants,
+                                  it->initial,
+                                  it->millis)};
         if (error::handle(result) == tsp::State::ERROR) {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -1214,7 +1504,16 @@ requires std::forward_iterator<Itr> &&
                                    *it->calc_children_per_itr,
                                    *it->calc_max_children_per_pair,
                                    *it->calc_max_v_count_crossover,
-                                   i)};
+                                   i,
+                                   it->crossover,
+                                   it->local_search,
+                                   it->local_search_moves,
+                                   it->neighbours,
+                                   it->islands,
+                                   it->migration_interval,
+                                   it->migrants,
+                                   it->initial,
+                                   it->millis)};
         if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -1251,7 +1550,7 @@ requires std::forward_iterator<Itr> &&
           it->calc_mutations_per_1000 = i;
         }
 
-        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f}\n",
+        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f};{};{}\n",
                             v_count,
                             instance_name,
                             optimal_cost,
@@ -1263,7 +1562,9 @@ requires std::forward_iterator<Itr> &&
                             v_count_crossover,
                             mutations,
                             time_us,
-                            error_percent);
+                            error_percent,
+                            time_to_target_us(run),
+                            run.seed);
       }
     }
   }
@@ -1291,7 +1592,7 @@ const char* out) noexcept {
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     for (int i {min_itr}; i <= max_itr; i += step_itr) {
@@ -1314,7 +1615,16 @@ const char* out) noexcept {
                                   *it->calc_children_per_itr,
                                   *it->calc_max_children_per_pair,
                                   *it->calc_max_v_count_crossover,
-                                  *it->calc_mutations_per_1000)};
+                                  *it->calc_mutations_per_1000,
+                                  it->crossover,
+                                  it->local_search,
+                                  it->local_search_moves,
+                                  it->neighbours,
+                                  it->islands,
+                                  it->migration_interval,
+                                  it->migrants,
+                                  it->initial,
+                                  it->millis)};
         if (error::handle(result) == tsp::State::ERROR) {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -1335,7 +1645,16 @@ const char* out) noexcept {
                                    *it->calc_children_per_itr,
                                    *it->calc_max_children_per_pair,
                                    *it->calc_max_v_count_crossover,
-                                   *it->calc_mutations_per_1000)};
+                                   *it->calc_mutations_per_1000,
+                                   it->crossover,
+                                   it->local_search,
+                                   it->local_search_moves,
+                                   it->neighbours,
+                                   it->islands,
+                                   it->migration_interval,
+                                   it->migrants,
+                                   it->initial,
+                                   it->millis)};
         if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
           return tsp::ErrorMeasure::ALGORITHM_ERROR;
         }
@@ -1367,7 +1686,7 @@ const char* out) noexcept {
           fmt::format("{:.2f}", run.time.count() * 1000.)};
         const double error_percent {run.error_info->relative_percent};
 
-        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f}\n",
+        file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f};{};{}\n",
                             v_count,
                             instance_name,
                             optimal_cost,
@@ -1379,7 +1698,9 @@ const char* out) noexcept {
                             v_count_crossover,
                             mutations,
                             time_us,
-                            error_percent);
+                            error_percent,
+                            time_to_target_us(run),
+                            run.seed);
       }
     }
   }
@@ -1408,7 +1729,7 @@ const char* out) noexcept {
   }
 
   file
-  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%]\n";
+  << "Ilosc miast;Nazwa;Koszt optymalny;Koszt obliczony;Ilosc iteracji;Rozmiar populacji;Maks ilosc dzieci na iteracje;Maks dzieci na pare;Maks wierzcholkow krzyzowania;Szansa na mutacje [%];Czas [us];Blad [%];Czas do celu [us];Ziarno\n";
 
   for (Itr it {begin}; it != end; ++it) {
     if (verbose) {
@@ -1430,7 +1751,16 @@ const char* out) noexcept {
                                 children_per_itr,
                                 *it->calc_max_children_per_pair,
                                 *it->calc_max_v_count_crossover,
-                                mutations_per_1000)};
+                                mutations_per_1000,
+                                it->crossover,
+                                it->local_search,
+                                it->local_search_moves,
+                                it->neighbours,
+                                it->islands,
+                                it->migration_interval,
+                                it->migrants,
+                                it->initial,
+                                it->millis)};
       if (error::handle(result) == tsp::State::ERROR) {
         return tsp::ErrorMeasure::ALGORITHM_ERROR;
       }
@@ -1451,7 +1781,16 @@ const char* out) noexcept {
                                  children_per_itr,
                                  *it->calc_max_children_per_pair,
                                  *it->calc_max_v_count_crossover,
-                                 mutations_per_1000)};
+                                 mutations_per_1000,
+                                 it->crossover,
+                                 it->local_search,
+                                 it->local_search_moves,
+                                 it->neighbours,
+                                 it->islands,
+                                 it->migration_interval,
+                                 it->migrants,
+                                 it->initial,
+                                 it->millis)};
       if (error::handle(result_) == tsp::State::ERROR) [[unlikely]] {
         return tsp::ErrorMeasure::ALGORITHM_ERROR;
       }
@@ -1482,7 +1821,7 @@ const char* out) noexcept {
         fmt::format("{:.2f}", run.time.count() * 1000.)};
       const double error_percent {run.error_info->relative_percent};
 
-      file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f}\n",
+      file << fmt::format("{};{};{};{};{};{};{};{};{};{};{};{:.2f};{};{}\n",
                           v_count,
                           instance_name,
                           optimal_cost,
@@ -1494,7 +1833,9 @@ const char* out) noexcept {
                           v_count_crossover,
                           mutations,
                           time_us,
-                          error_percent);
+                          error_percent,
+                          time_to_target_us(run),
+                          run.seed);
     }
   }
 
@@ -1556,6 +1897,17 @@ const char* out_n) noexcept {
     instances.at(i).calc_max_children_per_pair = std::nullopt;
     instances.at(i).calc_max_v_count_crossover = std::nullopt;
     instances.at(i).calc_mutations_per_1000    = std::nullopt;
+    instances.at(i).crossover                  = itr->params.genetic.crossover;
+    instances.at(i).local_search               = itr->params.genetic.local_search;
+    instances.at(i).local_search_moves         = itr->params.genetic.local_search_moves;
+    instances.at(i).islands                    = itr->params.genetic.islands;
+    instances.at(i).migration_interval         = itr->params.genetic.migration_interval;
+    instances.at(i).migrants                   = itr->params.genetic.migrants;
+    instances.at(i).initial                    = itr->params.genetic.initial;
+    instances.at(i).millis                     = itr->params.genetic.millis;
+    instances.at(i).neighbours                 = util::neighbours::Lists {
+      instances.at(i).matrix,
+      gen::neighbour_width(instances.at(i).local_search)};
 
     ++i;
   }
@@ -1663,13 +2015,13 @@ bool verbose) noexcept {
 
   std::optional<tsp::ErrorMeasure> err {std::nullopt};
 
-  err =
-  z1z2_measure_trivial_symmetric(nn::run, 20, verbose, "./measure_nn_s.csv");
+  err = z1z2_measure_trivial_symmetric(
+  nn::run, 20, verbose, "./measure_nn_s.csv", nn::SINGLE_PATH);
   if (err.has_value()) {
     return err;
   }
-  err =
-  z1z2_measure_trivial_asymmetric(nn::run, 19, verbose, "./measure_nn_as.csv");
+  err = z1z2_measure_trivial_asymmetric(
+  nn::run, 19, verbose, "./measure_nn_as.csv", nn::SINGLE_PATH);
   if (err.has_value()) {
     return err;
   }
@@ -1752,14 +2104,18 @@ static std::optional<tsp::ErrorMeasure> bxb_least_cost(bool verbose) noexcept {
   err = z1z2_measure_trivial_symmetric(bxb::lc::run,
                                        16,
                                        verbose,
-                                       "./measure_lc_s.csv");
+                                       "./measure_lc_s.csv",
+                                       tsp::Construction::NEAREST_NEIGHBOUR,
+                                       nullptr);
   if (err.has_value()) {
     return err;
   }
   err = z1z2_measure_trivial_asymmetric(bxb::lc::run,
                                         18,
                                         verbose,
-                                        "./measure_lc_as.csv");
+                                        "./measure_lc_as.csv",
+                                        tsp::Construction::NEAREST_NEIGHBOUR,
+                                        nullptr);
   if (err.has_value()) {
     return err;
   }
@@ -1782,14 +2138,16 @@ static std::optional<tsp::ErrorMeasure> bxb_bfs(bool verbose) noexcept {
   err = z1z2_measure_trivial_symmetric(bxb::bfs::run,
                                        14,
                                        verbose,
-                                       "./measure_bb_s.csv");
+                                       "./measure_bb_s.csv",
+                                       tsp::Construction::NEAREST_NEIGHBOUR);
   if (err.has_value()) {
     return err;
   }
   err = z1z2_measure_trivial_asymmetric(bxb::bfs::run,
                                         17,
                                         verbose,
-                                        "./measure_bb_as.csv");
+                                        "./measure_bb_as.csv",
+                                        tsp::Construction::NEAREST_NEIGHBOUR);
   if (err.has_value()) {
     return err;
   }
@@ -1812,14 +2170,16 @@ static std::optional<tsp::ErrorMeasure> bxb_dfs(bool verbose) noexcept {
   err = z1z2_measure_trivial_symmetric(bxb::dfs::run,
                                        19,
                                        verbose,
-                                       "./measure_bd_s.csv");
+                                       "./measure_bd_s.csv",
+                                       tsp::Construction::NEAREST_NEIGHBOUR);
   if (err.has_value()) {
     return err;
   }
   err = z1z2_measure_trivial_asymmetric(bxb::dfs::run,
                                         17,
                                         verbose,
-                                        "./measure_bd_as.csv");
+                                        "./measure_bd_as.csv",
+                                        tsp::Construction::NEAREST_NEIGHBOUR);
   if (err.has_value()) {
     return err;
   }
@@ -1831,6 +2191,36 @@ static std::optional<tsp::ErrorMeasure> bxb_dfs(bool verbose) noexcept {
   }
   return std::nullopt;
 }
+
+static std::optional<tsp::ErrorMeasure> held_karp(bool verbose) noexcept {
+  if (verbose) {
+    fmt::print("---\nMeasuring Held-Karp\n");
+  }
+
+  std::optional<tsp::ErrorMeasure> err {std::nullopt};
+
+  err = z1z2_measure_trivial_symmetric(hk::run,
+                                       20,
+                                       verbose,
+                                       "./measure_hk_s.csv");
+  if (err.has_value()) {
+    return err;
+  }
+  err = z1z2_measure_trivial_asymmetric(hk::run,
+                                        19,
+                                        verbose,
+                                        "./measure_hk_as.csv");
+  if (err.has_value()) {
+    return err;
+  }
+
+  if (verbose) {
+    fmt::print("OK\n");
+  } else {
+    fmt::print("HK: DONE\n");
+  }
+  return std::nullopt;
+}
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
@@ -1990,6 +2380,84 @@ static std::optional<tsp::ErrorMeasure> tabu_search(bool verbose) noexcept {
   }
   return std::nullopt;
 }
+
+static std::optional<tsp::ErrorMeasure> local_search(bool verbose) noexcept {
+  if (verbose) {
+    fmt::print("---\nMeasuring Local Search\n");
+  }
+
+  std::optional<tsp::ErrorMeasure> err {std::nullopt};
+
+  {
+    const std::array configs {
+      "./data/tsplib_tsp/configs/200_kroA200.ini",
+      "./data/tsplib_tsp/configs/318_lin318.ini",
+      "./data/tsplib_tsp/configs/442_pcb442.ini",
+      "./data/tsplib_tsp/configs/532_att532.ini",
+      "./data/tsplib_tsp/configs/574_u574.ini",
+      "./data/tsplib_tsp/configs/575_rat575.ini",
+      "./data/tsplib_tsp/configs/657_d657.ini",
+      "./data/tsplib_tsp/configs/724_u724.ini",
+      "./data/tsplib_tsp/configs/783_rat783.ini",
+    };
+
+    std::array<tsp::Instance, configs.size()> tsplib_symmetric {};
+
+    int i {0};
+    for (const auto& config : configs) {
+      auto instance_ {config::read(config)};
+      if (error::handle(instance_) == tsp::State::ERROR) {
+        return tsp::ErrorMeasure::FILE_ERROR;
+      }
+      tsplib_symmetric.at(i) = std::move(std::get<tsp::Instance>(instance_));
+      ++i;
+    }
+
+    err = z3_measure_local_search(tsplib_symmetric.begin(),
+                                  tsplib_symmetric.end(),
+                                  verbose,
+                                  "./measure_ls_libs.csv");
+    if (err.has_value()) {
+      return err;
+    }
+  }
+
+  {
+    const std::array configs {
+      "./data/tsplib_atsp/configs/100_kro124p.ini",
+      "./data/tsplib_atsp/configs/171_ftv170.ini",
+      "./data/tsplib_atsp/configs/323_rbg323.ini",
+      "./data/tsplib_atsp/configs/443_rbg443.ini",
+    };
+
+    std::array<tsp::Instance, configs.size()> tsplib_asymmetric {};
+
+    int i {0};
+    for (const auto& config : configs) {
+      auto instance_ {config::read(config)};
+      if (error::handle(instance_) == tsp::State::ERROR) {
+        return tsp::ErrorMeasure::FILE_ERROR;
+      }
+      tsplib_asymmetric.at(i) = std::move(std::get<tsp::Instance>(instance_));
+      ++i;
+    }
+
+    err = z3_measure_local_search(tsplib_asymmetric.begin(),
+                                  tsplib_asymmetric.end(),
+                                  verbose,
+                                  "./measure_ls_liba.csv");
+    if (err.has_value()) {
+      return err;
+    }
+  }
+
+  if (verbose) {
+    fmt::print("OK\n");
+  } else {
+    fmt::print("LS: DONE\n");
+  }
+  return std::nullopt;
+}
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -2239,6 +2707,13 @@ std::variant<std::monostate, tsp::ErrorMeasure> execute_measurements(
 const tsp::MeasuringRun& run) noexcept {
   std::optional<tsp::ErrorMeasure> err {std::nullopt};
 
+  // every run gets its own seed derived from this one, written to the csv
+  const uint64_t seed {run.seed.value_or(util::rng::random_seed())};
+  util::rng::set_seed(seed);
+  if (run.verbose) {
+    fmt::println("Seed: {}", seed);
+  }
+
   for (const auto& algo : run.algorithms) {
     switch (algo) {
 #if defined(ZADANIE1) && ZADANIE1 == 1
@@ -2263,12 +2738,18 @@ const tsp::MeasuringRun& run) noexcept {
       case tsp::Algorithm::BXB_DFS:
         err = measure::bxb_dfs(run.verbose);
         break;
+      case tsp::Algorithm::HELD_KARP:
+        err = measure::held_karp(run.verbose);
+        break;
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
       case tsp::Algorithm::TABU_SEARCH:
         err = measure::tabu_search(run.verbose);
         break;
+      case tsp::Algorithm::LOCAL_SEARCH:
+        err = measure::local_search(run.verbose);
+        break;
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
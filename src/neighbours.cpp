@@ -0,0 +1,63 @@
+#include "neighbours.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace util::neighbours {
+
+Lists::Lists(const tsp::CostMatrix& matrix, const int k) noexcept:
+  width {std::clamp(k, 0, std::max(static_cast<int>(matrix.size()) - 1, 0))},
+  limit {width} {
+  if (width == 0) {
+    return;
+  }
+
+  auto built {std::make_shared<Rows>(
+  Rows {.candidates = std::vector<int>(matrix.size() * width),
+        .counts     = std::vector<int>(matrix.size(), 0)})};
+  std::vector<int>& entries {built->candidates};
+  std::vector<int>& entry_counts {built->counts};
+
+  std::vector<int> order {};
+  order.reserve(matrix.size());
+
+  for (int vertex {0}; vertex < static_cast<int>(matrix.size()); ++vertex) {
+    order.clear();
+    for (int next {0}; next < static_cast<int>(matrix.size()); ++next) {
+      if (next != vertex && matrix(vertex, next) != -1) {
+        order.emplace_back(next);
+      }
+    }
+
+    // only the k cheapest are needed, ties keep the lower vertex first
+    const auto listed {order.begin() +
+                       std::min(static_cast<ptrdiff_t>(width),
+                                static_cast<ptrdiff_t>(order.size()))};
+    std::partial_sort(
+    order.begin(), listed, order.end(), [&](int lhs, int rhs) noexcept {
+      const int lhs_cost {matrix(vertex, lhs)};
+      const int rhs_cost {matrix(vertex, rhs)};
+      return lhs_cost != rhs_cost ? lhs_cost < rhs_cost : lhs < rhs;
+    });
+
+    std::copy(order.begin(),
+              listed,
+              entries.begin() + static_cast<ptrdiff_t>(vertex) * width);
+    entry_counts.at(vertex) = static_cast<int>(listed - order.begin());
+  }
+
+  candidates = entries.data();
+  counts     = entry_counts.data();
+  rows       = std::move(built);
+}
+
+Lists Lists::narrowed(const int k) const noexcept {
+  Lists view {*this};
+  view.limit = std::clamp(k, 0, width);
+  return view;
+}
+
+}    // namespace util::neighbours
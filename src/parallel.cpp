@@ -0,0 +1,115 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+namespace util::parallel {
+
+namespace {
+
+thread_local bool inside_pool {false};
+
+}    // namespace
+
+ThreadPool::ThreadPool(const int thread_count) noexcept {
+  threads.reserve(std::max(thread_count, 1));
+  for (int worker {0}; worker < std::max(thread_count, 1); ++worker) {
+    threads.emplace_back([this, worker]() noexcept {
+      work(worker);
+    });
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+  {
+    const std::scoped_lock lock {state_mutex};
+    stopping = true;
+  }
+  wake.notify_all();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::run(const int task_count_in, const Task& task) noexcept {
+  if (task_count_in < 1) [[unlikely]] {
+    return;
+  }
+
+  // nested call from a task, the workers are already taken
+  if (inside_pool) [[unlikely]] {
+    for (int index {0}; index < task_count_in; ++index) {
+      task(0, index);
+    }
+    return;
+  }
+
+  const std::scoped_lock run_lock {run_mutex};
+
+  std::unique_lock lock {state_mutex};
+  current_task = &task;
+  task_count   = task_count_in;
+  next_task    = 0;
+  busy_workers = size();
+  ++generation;
+  lock.unlock();
+
+  wake.notify_all();
+
+  lock.lock();
+  done.wait(lock, [this]() noexcept {
+    return busy_workers == 0;
+  });
+  current_task = nullptr;
+}
+
+int ThreadPool::size() const noexcept {
+  return static_cast<int>(threads.size());
+}
+
+int ThreadPool::concurrency() const noexcept {
+  return inside_pool ? 1 : size();
+}
+
+void ThreadPool::work(const int worker) noexcept {
+  inside_pool = true;
+
+  uint64_t seen_generation {0};
+
+  while (true) {
+    std::unique_lock lock {state_mutex};
+    wake.wait(lock, [this, &seen_generation]() noexcept {
+      return stopping || generation != seen_generation;
+    });
+
+    if (stopping) {
+      return;
+    }
+    seen_generation = generation;
+
+    // take task indices one at a time until the counter runs out
+    while (next_task < task_count) {
+      const int index {next_task++};
+      lock.unlock();
+      (*current_task)(worker, index);
+      lock.lock();
+    }
+
+    if (--busy_workers == 0) {
+      done.notify_one();
+    }
+  }
+}
+
+int hardware_threads() noexcept {
+  return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+}
+
+ThreadPool& shared_pool() noexcept {
+  static ThreadPool pool {hardware_threads()};
+  return pool;
+}
+
+}    // namespace util::parallel
@@ -0,0 +1,81 @@
+#include "rng.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+
+namespace util::rng {
+
+namespace {
+
+[[nodiscard]] uint64_t splitmix64(uint64_t& state) noexcept {
+  uint64_t value {state += 0x9E3779B97F4A7C15};
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+  return value ^ (value >> 31);
+}
+
+std::atomic<uint64_t> base_seed {random_seed()};
+std::atomic<uint64_t> run_index {0};
+std::atomic<uint64_t> current_seed {0};
+
+}    // namespace
+
+Xoshiro256::Xoshiro256(uint64_t seed, const uint64_t stream) noexcept {
+  for (uint64_t& word : state) {
+    word = splitmix64(seed);
+  }
+  for (uint64_t i {0}; i < stream; ++i) {
+    jump();
+  }
+}
+
+void Xoshiro256::jump() noexcept {
+  constexpr static uint64_t JUMP[] {0x180EC6D33CFD0ABA,
+                                    0xD5A61266F0C9392C,
+                                    0xA9582618E03FC9AA,
+                                    0x39ABDC4529B1661C};
+
+  uint64_t jumped[4] {0, 0, 0, 0};
+  for (const uint64_t word : JUMP) {
+    for (int bit {0}; bit < 64; ++bit) {
+      if ((word & (uint64_t {1} << bit)) != 0) {
+        for (int i {0}; i < 4; ++i) {
+          jumped[i] ^= state[i];
+        }
+      }
+      operator()();
+    }
+  }
+  for (int i {0}; i < 4; ++i) {
+    state[i] = jumped[i];
+  }
+}
+
+uint64_t random_seed() noexcept {
+  std::random_device device {};
+  return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+void set_seed(const uint64_t seed) noexcept {
+  base_seed.store(seed);
+  run_index.store(0);
+}
+
+uint64_t begin_run() noexcept {
+  const uint64_t index {run_index.fetch_add(1)};
+  uint64_t       mixed {base_seed.load() + index};
+  const uint64_t seed {index == 0 ? base_seed.load() : splitmix64(mixed)};
+  current_seed.store(seed);
+  return seed;
+}
+
+uint64_t run_seed() noexcept {
+  return current_seed.load();
+}
+
+Xoshiro256 stream(const uint64_t index) noexcept {
+  return {run_seed(), index};
+}
+
+}    // namespace util::rng
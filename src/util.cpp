@@ -10,25 +10,33 @@
   #include "zadanie_2/bxb_bfs.hpp"
   #include "zadanie_2/bxb_dfs.hpp"
   #include "zadanie_2/bxb_lc.hpp"
+  #include "zadanie_2/hk.hpp"
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
   #include "zadanie_3/ts.hpp"
+  #include "zadanie_3/ts_kernel.hpp"
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
   #include "zadanie_4/gen.hpp"
 #endif
 
+#include "parallel.hpp"
+
 #include <fmt/core.h>
 
 #include <INIReader.h>
 #include <array>
+#include <charconv>
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
 #include <optional>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <variant>
 #include <vector>
 
@@ -40,21 +48,44 @@ void help_page() noexcept {
   "[instance]\n"
   "input_path = <input path string>\n"
   "(optional) symmetric = <symmetric graph? bool>\n"
-  "(optional) full = <full graph? bool>\n\n"
+  "(optional) full = <full graph? bool>\n"
+  "(optional) seed = <integer seed of the random generators, default random>\n\n"
   "[optimal]\n"
   "(optional) path = <integer node><space><integer node><space>...\n"
   "(optional) cost = <integer cost>\n\n"
 
 #if defined(ZADANIE1) && ZADANIE1 == 1
+  "[nearest_neighbour]\n"
+  "(optional) beam = <integer partial tours kept per step, 1 = single greedy "
+  "path, default 1>\n\n"
   "[random]\n"
   "millis = <integer running time in ms>\n\n"
 #endif
 
+#if defined(ZADANIE2) && ZADANIE2 == 1
+  "[branch_and_bound]\n"
+  "(optional) initial = <nn | greedy | insertion | mst upper bound tour, "
+  "default nn>\n\n"
+#endif
+
 #if defined(ZADANIE3) && ZADANIE3 == 1
   "[tabu_search]\n"
   "itr = <integer max iterations>\n"
   "max_itr_no_improve = <integer iterations to halt with no improvement>\n"
-  "tabu_itr = <integer iterations in tabu>\n\n"
+  "tabu_itr = <integer iterations in tabu>\n"
+  "(optional) neighbourhood = <swap | 2opt | or-opt, default swap>\n"
+  "(optional) candidates = <integer nearest neighbours per vertex, 0 = all>\n"
+  "(optional) threads = <integer threads scanning neighbourhood, default 1, above 1 only with starts = 1>\n"
+  "(optional) starts = <integer parallel searches from different tours, default 1>\n"
+  "(optional) local_search = <none | 2opt | oropt | 3opt | all polishing the "
+  "best tour, default none>\n"
+  "(optional) initial = <nn | greedy | insertion | mst starting tour, default nn>\n"
+  "(optional) millis = <integer running time limit in ms, 0 = none>\n\n"
+  "[local_search]\n"
+  "(optional) method = <2opt | oropt | 3opt | all, default all>\n"
+  "(optional) candidates = <integer nearest neighbours per vertex, default 16>\n"
+  "(optional) initial = <nn | greedy | insertion | mst improved tour, default "
+  "greedy>\n\n"
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -64,28 +95,56 @@ void help_page() noexcept {
   "children_per_itr = <integer count of all children in itr>\n"
   "max_children_per_pair = <integer max children per pair>\n"
   "max_v_count_crossover = <integer max vertices to crossover>\n"
-  "mutations_per_1000 = <integer ppt of chromosomes to mutate>\n\n"
+  "mutations_per_1000 = <integer ppt of chromosomes to mutate>\n"
+  "(optional) crossover = <splice | ox | pmx | erx, default splice>\n"
+  "(optional) local_search = <none | 2opt | oropt | 3opt | all applied to children, default none>\n"
+  "(optional) local_search_moves = <integer moves per child, 0 = to local optimum, default 50>\n"
+  "(optional) islands = <integer populations on own threads, default 1>\n"
+  "(optional) migration_interval = <integer generations between migrations, default 50>\n"
+  "(optional) migrants = <integer chromosomes sent to the next island, default 2>\n"
+  "(optional) initial = <nn | greedy | insertion | mst tour the population is "
+  "derived from, default nn>\n"
+  "(optional) millis = <integer running time limit in ms, 0 = none>\n\n"
 #endif
 
   "- Example:\n\n"
   "[instance]\n"
   "input_path = C:/dev/pea_z1_gusta/data/test_6_as.txt\n"
   "symmetric = false\n"
-  "full = true\n\n"
+  "full = true\n"
+  "seed = 12345\n\n"
   "[optimal]\n"
   "path = 2 3 0 1 4 5\n"
   "cost = 150\n\n"
 
 #if defined(ZADANIE1) && ZADANIE1 == 1
+  "[nearest_neighbour]\n"
+  "beam = 1\n\n"
   "[random]\n"
   "millis = 1000\n\n"
 #endif
 
+#if defined(ZADANIE2) && ZADANIE2 == 1
+  "[branch_and_bound]\n"
+  "initial = nn\n\n"
+#endif
+
 #if defined(ZADANIE3) && ZADANIE3 == 1
   "[tabu_search]\n"
   "itr = 10000\n"
   "max_itr_no_improve = 50\n"
-  "tabu_itr = 10\n\n"
+  "tabu_itr = 10\n"
+  "neighbourhood = 2opt\n"
+  "candidates = 10\n"
+  "threads = 4\n"
+  "starts = 1\n"
+  "local_search = none\n"
+  "initial = greedy\n"
+  "millis = 0\n\n"
+  "[local_search]\n"
+  "method = all\n"
+  "candidates = 16\n"
+  "initial = greedy\n\n"
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -95,11 +154,96 @@ void help_page() noexcept {
   "count_of_children = 50\n"
   "max_children_per_pair = 4\n"
   "max_v_count_crossover = 5\n"
-  "mutations_per_1000 = 5\n\n"
+  "mutations_per_1000 = 5\n"
+  "crossover = ox\n"
+  "local_search = 2opt\n"
+  "local_search_moves = 50\n"
+  "islands = 4\n"
+  "migration_interval = 50\n"
+  "migrants = 2\n"
+  "initial = nn\n"
+  "millis = 0\n\n"
 #endif
   );
 }
 
+#if (defined(ZADANIE2) && ZADANIE2 == 1) || (defined(ZADANIE3) && ZADANIE3 == 1) || \
+    (defined(ZADANIE4) && ZADANIE4 == 1)
+[[nodiscard]] static std::optional<tsp::Construction> parse_construction(
+const std::string& name) noexcept {
+  if (name == "nn") {
+    return tsp::Construction::NEAREST_NEIGHBOUR;
+  }
+  if (name == "greedy") {
+    return tsp::Construction::GREEDY;
+  }
+  if (name == "insertion") {
+    return tsp::Construction::INSERTION;
+  }
+  if (name == "mst") {
+    return tsp::Construction::MST;
+  }
+  return std::nullopt;
+}
+#endif
+
+#if (defined(ZADANIE3) && ZADANIE3 == 1) || (defined(ZADANIE4) && ZADANIE4 == 1)
+[[nodiscard]] static std::optional<tsp::LocalSearch> parse_local_search(
+const std::string& name) noexcept {
+  if (name == "none") {
+    return tsp::LocalSearch::NONE;
+  }
+  if (name == "2opt") {
+    return tsp::LocalSearch::TWO_OPT;
+  }
+  if (name == "oropt") {
+    return tsp::LocalSearch::OR_OPT;
+  }
+  if (name == "3opt") {
+    return tsp::LocalSearch::THREE_OPT;
+  }
+  if (name == "all") {
+    return tsp::LocalSearch::ALL;
+  }
+  return std::nullopt;
+}
+#endif
+
+#if defined(ZADANIE4) && ZADANIE4 == 1
+[[nodiscard]] static std::optional<tsp::Crossover> parse_crossover(
+const std::string& name) noexcept {
+  if (name == "splice") {
+    return tsp::Crossover::SPLICE;
+  }
+  if (name == "ox") {
+    return tsp::Crossover::OX;
+  }
+  if (name == "pmx") {
+    return tsp::Crossover::PMX;
+  }
+  if (name == "erx") {
+    return tsp::Crossover::ERX;
+  }
+  return std::nullopt;
+}
+#endif
+
+#if defined(ZADANIE3) && ZADANIE3 == 1
+[[nodiscard]] static std::optional<tsp::Neighbourhood> parse_neighbourhood(
+const std::string& name) noexcept {
+  if (name == "swap") {
+    return tsp::Neighbourhood::SWAP;
+  }
+  if (name == "2opt") {
+    return tsp::Neighbourhood::TWO_OPT;
+  }
+  if (name == "or-opt") {
+    return tsp::Neighbourhood::OR_OPT;
+  }
+  return std::nullopt;
+}
+#endif
+
 [[nodiscard]] std::variant<tsp::Instance, tsp::ErrorConfig> read(
 const std::filesystem::path& config_file) noexcept {
   const INIReader reader {config_file.generic_string()};
@@ -127,25 +271,110 @@ const std::filesystem::path& config_file) noexcept {
   if (error::handle(matrix_result) == tsp::State::ERROR) [[unlikely]] {
     return tsp::ErrorConfig::CAN_NOT_PROCEED;
   }
-  const tsp::Matrix<int> matrix {std::get<tsp::Matrix<int>>(matrix_result)};
+  const tsp::CostMatrix matrix {std::get<tsp::CostMatrix>(matrix_result)};
 
   const bool symmetric_graph {
     reader.GetBoolean("instance", "symmetric", false)};
   const bool full_graph {reader.GetBoolean("instance", "full", false)};
+  const std::optional<uint64_t> seed {
+    reader.HasValue("instance", "seed")
+    ? std::optional {reader.GetUnsigned64("instance", "seed", 0)}
+    : std::nullopt};
+
+#if defined(ZADANIE2) && ZADANIE2 == 1
+  const std::optional<tsp::Construction> bxb_initial {
+    parse_construction(reader.Get("branch_and_bound", "initial", "nn"))};
+  if (!bxb_initial.has_value()) [[unlikely]] {
+    return tsp::ErrorConfig::BAD_CONFIG;
+  }
+#endif
+
+#if defined(ZADANIE3) && ZADANIE3 == 1
+  const std::optional<tsp::Neighbourhood> neighbourhood {
+    parse_neighbourhood(reader.Get("tabu_search", "neighbourhood", "swap"))};
+  if (!neighbourhood.has_value()) [[unlikely]] {
+    return tsp::ErrorConfig::BAD_CONFIG;
+  }
+
+  const std::optional<tsp::Construction> ts_initial {
+    parse_construction(reader.Get("tabu_search", "initial", "nn"))};
+  if (!ts_initial.has_value()) [[unlikely]] {
+    return tsp::ErrorConfig::BAD_CONFIG;
+  }
+
+  const std::optional<tsp::LocalSearch> ts_local_search {
+    parse_local_search(reader.Get("tabu_search", "local_search", "none"))};
+  if (!ts_local_search.has_value()) [[unlikely]] {
+    return tsp::ErrorConfig::BAD_CONFIG;
+  }
+
+  const std::optional<tsp::LocalSearch> ls_method {
+    parse_local_search(reader.Get("local_search", "method", "all"))};
+  if (!ls_method.has_value()) [[unlikely]] {
+    return tsp::ErrorConfig::BAD_CONFIG;
+  }
+
+  const std::optional<tsp::Construction> ls_initial {
+    parse_construction(reader.Get("local_search", "initial", "greedy"))};
+  if (!ls_initial.has_value()) [[unlikely]] {
+    return tsp::ErrorConfig::BAD_CONFIG;
+  }
+#endif
+
+#if defined(ZADANIE4) && ZADANIE4 == 1
+  const std::optional<tsp::Crossover> crossover {
+    parse_crossover(reader.Get("genetic", "crossover", "splice"))};
+  if (!crossover.has_value()) [[unlikely]] {
+    return tsp::ErrorConfig::BAD_CONFIG;
+  }
+
+  const std::optional<tsp::LocalSearch> local_search {
+    parse_local_search(reader.Get("genetic", "local_search", "none"))};
+  if (!local_search.has_value()) [[unlikely]] {
+    return tsp::ErrorConfig::BAD_CONFIG;
+  }
+
+  const std::optional<tsp::Construction> genetic_initial {
+    parse_construction(reader.Get("genetic", "initial", "nn"))};
+  if (!genetic_initial.has_value()) [[unlikely]] {
+    return tsp::ErrorConfig::BAD_CONFIG;
+  }
+#endif
 
   const tsp::Param algo_params {
 #if defined(ZADANIE1) && ZADANIE1 == 1
+    .nearest_neighbour = {.beam = static_cast<int>(
+                          reader.GetInteger("nearest_neighbour", "beam", 1))},
     .random = {.millis =
                static_cast<int>(reader.GetInteger("random", "millis", -1))},
 #endif
 
+#if defined(ZADANIE2) && ZADANIE2 == 1
+    .branch_and_bound = {.initial = *bxb_initial},
+#endif
+
 #if defined(ZADANIE3) && ZADANIE3 == 1
     .tabu_search = {.itr = static_cast<int>(
                     reader.GetInteger("tabu_search", "itr", -1)),
                .max_itr_no_improve = static_cast<int>(
                     reader.GetInteger("tabu_search", "max_itr_no_improve", -1)),
                .tabu_itr = static_cast<int>(
-                    reader.GetInteger("tabu_search", "tabu_itr", -1))},
+                    reader.GetInteger("tabu_search", "tabu_itr", -1)),
+               .neighbourhood = *neighbourhood,
+               .candidates = static_cast<int>(
+                    reader.GetInteger("tabu_search", "candidates", 0)),
+               .threads = static_cast<int>(
+                    reader.GetInteger("tabu_search", "threads", 1)),
+               .starts = static_cast<int>(
+                    reader.GetInteger("tabu_search", "starts", 1)),
+               .local_search = *ts_local_search,
+               .initial = *ts_initial,
+               .millis = static_cast<int>(
+                    reader.GetInteger("tabu_search", "millis", 0))},
+    .local_search = {.method = *ls_method,
+               .candidates = static_cast<int>(
+                    reader.GetInteger("local_search", "candidates", 16)),
+               .initial = *ls_initial},
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -160,7 +389,20 @@ const std::filesystem::path& config_file) noexcept {
                .max_v_count_crossover = static_cast<int>(
                 reader.GetInteger("genetic", "max_v_count_crossover", -1)),
                .mutations_per_1000 = static_cast<int>(
-                reader.GetInteger("genetic", "mutations_per_1000", -1))}
+                reader.GetInteger("genetic", "mutations_per_1000", -1)),
+               .crossover = *crossover,
+               .local_search = *local_search,
+               .local_search_moves = static_cast<int>(
+                reader.GetInteger("genetic", "local_search_moves", 50)),
+               .islands = static_cast<int>(
+                reader.GetInteger("genetic", "islands", 1)),
+               .migration_interval = static_cast<int>(
+                reader.GetInteger("genetic", "migration_interval", 50)),
+               .migrants = static_cast<int>(
+                reader.GetInteger("genetic", "migrants", 2)),
+               .initial = *genetic_initial,
+               .millis = static_cast<int>(
+                reader.GetInteger("genetic", "millis", 0))}
 #endif
   };
 
@@ -208,7 +450,8 @@ const std::filesystem::path& config_file) noexcept {
                     .cost = optimal_solution_cost},
     .params      = algo_params,
     .graph_info  = {  .symmetric_graph = symmetric_graph,
-                    .full_graph      = full_graph}
+                    .full_graph      = full_graph},
+    .seed        = seed
   };
 }
 
@@ -237,19 +480,95 @@ const tsp::Time& duration) noexcept {
   return {.count = duration.count(), .unit = "ms"};    // milliseconds
 }
 
-void report(const tsp::SingleRun& arguments,
-            const tsp::Instance&  instance,
-            const tsp::Result&    result) noexcept {
+#if (defined(ZADANIE2) && ZADANIE2 == 1) || (defined(ZADANIE3) && ZADANIE3 == 1) || \
+    (defined(ZADANIE4) && ZADANIE4 == 1)
+[[nodiscard]] constexpr static std::string_view construction_name(
+tsp::Construction construction) noexcept {
+  switch (construction) {
+    case tsp::Construction::NEAREST_NEIGHBOUR:
+      return "nn";
+    case tsp::Construction::GREEDY:
+      return "greedy";
+    case tsp::Construction::INSERTION:
+      return "insertion";
+    case tsp::Construction::MST:
+      return "mst";
+  }
+  return "unknown";
+}
+#endif
+
+#if (defined(ZADANIE3) && ZADANIE3 == 1) || (defined(ZADANIE4) && ZADANIE4 == 1)
+[[nodiscard]] constexpr static std::string_view local_search_name(
+tsp::LocalSearch local_search) noexcept {
+  switch (local_search) {
+    case tsp::LocalSearch::NONE:
+      return "none";
+    case tsp::LocalSearch::TWO_OPT:
+      return "2opt";
+    case tsp::LocalSearch::OR_OPT:
+      return "oropt";
+    case tsp::LocalSearch::THREE_OPT:
+      return "3opt";
+    case tsp::LocalSearch::ALL:
+      return "all";
+  }
+  return "unknown";
+}
+#endif
+
+#if defined(ZADANIE4) && ZADANIE4 == 1
+[[nodiscard]] constexpr static std::string_view crossover_name(
+tsp::Crossover crossover) noexcept {
+  switch (crossover) {
+    case tsp::Crossover::SPLICE:
+      return "splice";
+    case tsp::Crossover::OX:
+      return "ox";
+    case tsp::Crossover::PMX:
+      return "pmx";
+    case tsp::Crossover::ERX:
+      return "erx";
+  }
+  return "unknown";
+}
+#endif
+
+#if defined(ZADANIE3) && ZADANIE3 == 1
+[[nodiscard]] constexpr static std::string_view neighbourhood_name(
+tsp::Neighbourhood neighbourhood) noexcept {
+  switch (neighbourhood) {
+    case tsp::Neighbourhood::SWAP:
+      return "swap";
+    case tsp::Neighbourhood::TWO_OPT:
+      return "2opt";
+    case tsp::Neighbourhood::OR_OPT:
+      return "or-opt";
+  }
+  return "unknown";
+}
+#endif
+
+// thread_stats is only printed for the least cost branch and bound
+void report(
+const tsp::SingleRun&                              arguments,
+const tsp::Instance&                               instance,
+const tsp::Result&                                 result,
+[[maybe_unused]] std::span<const tsp::ThreadStats> thread_stats) noexcept {
   const auto& [matrix,
                config_filename,
                input_filename,
                optimal_solution,
                params,
-               graph_info] {instance};
-  const auto& [solution, time, error_info] {result};
+               graph_info,
+               config_seed] {instance};
+  const auto& [solution, time, error_info, trace, time_to_target, seed] {
+    result};
   const auto [count, unit] {parse_duration(time)};
 
+#if defined(ZADANIE1) && ZADANIE1 == 1
   const bool optimized {graph_info.full_graph && graph_info.symmetric_graph};
+#endif
 
   fmt::println("Config ({})", config_filename.generic_string());
   fmt::println("- Input file: {}", input_filename.generic_string());
@@ -271,17 +590,20 @@ void report(const tsp::SingleRun& arguments,
   switch (arguments.algorithm) {
 #if defined(ZADANIE1) && ZADANIE1 == 1
     case tsp::Algorithm::BRUTE_FORCE:
-      fmt::println("Algorithm (Brute Force)\n");
-      if (optimized) {
-        fmt::println(
-        "Optimization: Single Starting Vertex (full, symmetric)\n");
-      }
+      fmt::println("Algorithm (Brute Force)");
+      fmt::println("- Threads: {}\n", parallel::shared_pool().size());
+      fmt::println("Optimization: Single Starting Vertex\n");
       break;
     case tsp::Algorithm::NEAREST_NEIGHBOUR:
-      fmt::println("Algorithm (Nearest Neighbour)\n");
+      fmt::println("Algorithm (Nearest Neighbour)");
+      fmt::println("- Beam width: {}", params.nearest_neighbour.beam);
       if (optimized) {
+        fmt::println("- Threads: 1\n");
         fmt::println(
         "Optimization: Single Starting Vertex (full, symmetric)\n");
+      } else {
+        fmt::println("- Threads: {}\n", parallel::shared_pool().size());
+        fmt::println("Optimization: Parallel Starting Vertices\n");
       }
       break;
     case tsp::Algorithm::RANDOM:
@@ -292,25 +614,34 @@ void report(const tsp::SingleRun& arguments,
 
 #if defined(ZADANIE2) && ZADANIE2 == 1
     case tsp::Algorithm::BXB_LEAST_COST:
-      fmt::println("Algorithm (BxB Least Cost)\n");
-      if (optimized) {
-        fmt::println(
-        "Optimization: Single Starting Vertex (full, symmetric)\n");
+      fmt::println("Algorithm (BxB Least Cost)");
+      fmt::println("- Initial tour: {}",
+                   construction_name(params.branch_and_bound.initial));
+      fmt::println("- Threads: {}", thread_stats.size());
+      for (size_t i {0}; i < thread_stats.size(); ++i) {
+        fmt::println("- Thread {}: expanded {}, pruned {}, leaves {}",
+                     i,
+                     thread_stats[i].expanded,
+                     thread_stats[i].pruned,
+                     thread_stats[i].leaves);
       }
+      fmt::println(
+      "\nOptimization: Single Starting Vertex, Lower Bound, Shared Queue\n");
       break;
     case tsp::Algorithm::BXB_BFS:
-      fmt::println("Algorithm (BxB BFS)\n");
-      if (optimized) {
-        fmt::println(
-        "Optimization: Single Starting Vertex (full, symmetric)\n");
-      }
+      fmt::println("Algorithm (BxB BFS)");
+      fmt::println("- Initial tour: {}\n",
+                   construction_name(params.branch_and_bound.initial));
+      fmt::println("Optimization: Single Starting Vertex, Lower Bound\n");
       break;
     case tsp::Algorithm::BXB_DFS:
-      fmt::println("Algorithm (BxB DFS)\n");
-      if (optimized) {
-        fmt::println(
-        "Optimization: Single Starting Vertex (full, symmetric)\n");
-      }
+      fmt::println("Algorithm (BxB DFS)");
+      fmt::println("- Initial tour: {}\n",
+                   construction_name(params.branch_and_bound.initial));
+      fmt::println("Optimization: Single Starting Vertex, Lower Bound\n");
+      break;
+    case tsp::Algorithm::HELD_KARP:
+      fmt::println("Algorithm (Held-Karp)\n");
       break;
 #endif
 
@@ -320,8 +651,46 @@ void report(const tsp::SingleRun& arguments,
       fmt::println("- Count of iterations: {}", params.tabu_search.itr);
       fmt::println("- Max iterations with no improvement: {}",
                    params.tabu_search.max_itr_no_improve);
-      fmt::println("- Count of iterations in tabu: {}\n",
+      fmt::println("- Count of iterations in tabu: {}",
                    params.tabu_search.tabu_itr);
+      fmt::println("- Neighbourhood: {}",
+                   neighbourhood_name(params.tabu_search.neighbourhood));
+      if (params.tabu_search.candidates == 0) {
+        fmt::println("- Candidate list: NONE");
+      } else {
+        fmt::println("- Candidate list: {} nearest",
+                     params.tabu_search.candidates);
+      }
+      if (params.tabu_search.neighbourhood == tsp::Neighbourhood::SWAP) {
+        fmt::println("- Swap kernel: {}",
+                     ts::kernel::uses_avx2() ? "AVX2" : "scalar");
+      }
+      fmt::println("- Threads: {}", params.tabu_search.threads);
+      fmt::println("- Starts: {}", params.tabu_search.starts);
+      if (params.tabu_search.local_search == tsp::LocalSearch::NONE) {
+        fmt::println("- Local search: NONE");
+      } else {
+        fmt::println("- Local search: {} to local optimum",
+                     local_search_name(params.tabu_search.local_search));
+      }
+      fmt::println("- Initial tour: {}",
+                   construction_name(params.tabu_search.initial));
+      if (params.tabu_search.millis == 0) {
+        fmt::println("- Time limit: NONE\n");
+      } else {
+        fmt::println("- Time limit: {} ms\n", params.tabu_search.millis);
+      }
+      break;
+    case tsp::Algorithm::LOCAL_SEARCH:
+      fmt::println("Algorithm (Local Search)");
+      fmt::println("- Method: {}",
+                   local_search_name(params.local_search.method));
+      fmt::println("- Candidate list: {} nearest",
+                   params.local_search.candidates);
+      fmt::println("- Initial tour: {}\n",
+                   construction_name(params.local_search.initial));
+      fmt::println("Optimization: Neighbour Lists, Don't-Look Bits, First "
+                   "Improvement\n");
       break;
 #endif
 
@@ -336,8 +705,32 @@ void report(const tsp::SingleRun& arguments,
                    params.genetic.max_children_per_pair);
       fmt::println("- Maximum number of vertices to crossover: {}",
                    params.genetic.max_v_count_crossover);
-      fmt::println("- Mutation chance: {:.1f}%\n",
+      fmt::println("- Mutation chance: {:.1f}%",
                    static_cast<double>(params.genetic.mutations_per_1000) / 10);
+      fmt::println("- Crossover: {}", crossover_name(params.genetic.crossover));
+      if (params.genetic.local_search == tsp::LocalSearch::NONE) {
+        fmt::println("- Local search: NONE");
+      } else if (params.genetic.local_search_moves == 0) {
+        fmt::println("- Local search: {} to local optimum",
+                     local_search_name(params.genetic.local_search));
+      } else {
+        fmt::println("- Local search: {}, {} moves per child",
+                     local_search_name(params.genetic.local_search),
+                     params.genetic.local_search_moves);
+      }
+      fmt::println("- Islands: {}", params.genetic.islands);
+      if (params.genetic.islands > 1) {
+        fmt::println("- Migration: {} best every {} generations (ring)",
+                     params.genetic.migrants,
+                     params.genetic.migration_interval);
+      }
+      fmt::println("- Initial tour: {}",
+                   construction_name(params.genetic.initial));
+      if (params.genetic.millis == 0) {
+        fmt::println("- Time limit: NONE\n");
+      } else {
+        fmt::println("- Time limit: {} ms\n", params.genetic.millis);
+      }
       break;
 #endif
 
@@ -347,7 +740,8 @@ void report(const tsp::SingleRun& arguments,
   }
 
   fmt::println("-- RESULTS --");
-  fmt::println("Time: {:.2f} {}\n", count, unit);
+  fmt::println("Time: {:.2f} {}", count, unit);
+  fmt::println("Seed: {}\n", seed);
   fmt::println("Cost: {}", solution.cost);
   if (matrix.size() <= 16) {
     fmt::print("Path: ");
@@ -361,6 +755,16 @@ void report(const tsp::SingleRun& arguments,
     fmt::println("Absolute error: {}", error_info->absolute);
     fmt::println("Relative error: {:.2f}%", error_info->relative_percent);
   }
+  if (!trace.empty()) {
+    fmt::println("");
+    fmt::println("Improvements: {}", trace.size());
+    fmt::println("Last improvement: {:.2f} ms", trace.back().elapsed.count());
+  }
+  if (time_to_target.has_value()) {
+    fmt::println("Time to target (optimum + {}%): {:.2f} ms",
+                 util::anytime::TARGET_PERCENT,
+                 time_to_target->count());
+  }
 }
 
 }    // namespace util::output
@@ -386,7 +790,7 @@ void help_page() noexcept {
 }
 
 // return: cost matrix from matrix format tsp
-[[nodiscard]] std::variant<tsp::Matrix<int>, tsp::ErrorRead> tsp_matrix(
+[[nodiscard]] std::variant<tsp::CostMatrix, tsp::ErrorRead> tsp_matrix(
 const std::filesystem::path& input_file) noexcept {
   size_t vertex_count {0};
 
@@ -406,12 +810,9 @@ const std::filesystem::path& input_file) noexcept {
     return tsp::ErrorRead::BAD_DATA;
   }
 
-  tsp::Matrix<int> cost_matrix {};
-  cost_matrix.resize(vertex_count);
+  tsp::CostMatrix cost_matrix {vertex_count, -2};
 
   for (int i = 0; i < vertex_count; ++i) {
-    cost_matrix.at(i).resize(vertex_count, -2);
-
     for (int j = 0; j < vertex_count; ++j) {
       int cost_read {-2};
       file >> cost_read;
@@ -420,7 +821,7 @@ const std::filesystem::path& input_file) noexcept {
         return tsp::ErrorRead::BAD_DATA;
       }
 
-      cost_matrix.at(i).at(j) = cost_read;
+      cost_matrix(i, j) = cost_read;
     }
   }
 
@@ -435,35 +836,35 @@ void help_page() noexcept {
   fmt::println(
   "Usage:\n"
   #if defined(ZADANIE1) && ZADANIE1 == 1
-  "(Single Run) ./pea_gusta_zadanie_1 --config=<config file path> <one of the algorithm flags>\n"
+  "(Single Run) ./pea_gusta_zadanie_1 --config=<config file path> (optional)--seed=<integer seed> <one of the algorithm flags>\n"
   #endif
 
   #if defined(ZADANIE2) && ZADANIE2 == 1
-  "(Single Run) ./pea_gusta_zadanie_2 --config=<config file path> <one of the algorithm flags>\n"
+  "(Single Run) ./pea_gusta_zadanie_2 --config=<config file path> (optional)--seed=<integer seed> <one of the algorithm flags>\n"
   #endif
 
   #if defined(ZADANIE3) && ZADANIE3 == 1
-  "(Single Run) ./pea_gusta_zadanie_3 --config=<config file path> <one of the algorithm flags>\n"
+  "(Single Run) ./pea_gusta_zadanie_3 --config=<config file path> (optional)--seed=<integer seed> <one of the algorithm flags>\n"
   #endif
 
   #if defined(ZADANIE4) && ZADANIE4 == 1
-  "(Single Run) ./pea_gusta_zadanie_4 --config=<config file path> <one of the algorithm flags>\n"
+  "(Single Run) ./pea_gusta_zadanie_4 --config=<config file path> (optional)--seed=<integer seed> <one of the algorithm flags>\n"
   #endif
 
   #if defined(ZADANIE1) && ZADANIE1 == 1
-  "(Measuring Run) ./pea_gusta_zadanie_1 --measure (optional)--verbose <one or more of the algorithm flags>\n\n"
+  "(Measuring Run) ./pea_gusta_zadanie_1 --measure (optional)--verbose (optional)--seed=<integer seed> <one or more of the algorithm flags>\n\n"
   #endif
 
   #if defined(ZADANIE2) && ZADANIE2 == 1
-  "(Measuring Run) ./pea_gusta_zadanie_2 --measure (optional)--verbose <one or more of the algorithm flags>\n\n"
+  "(Measuring Run) ./pea_gusta_zadanie_2 --measure (optional)--verbose (optional)--seed=<integer seed> <one or more of the algorithm flags>\n\n"
   #endif
 
   #if defined(ZADANIE3) && ZADANIE3 == 1
-  "(Measuring Run) ./pea_gusta_zadanie_3 --measure (optional)--verbose <one or more of the algorithm flags>\n\n"
+  "(Measuring Run) ./pea_gusta_zadanie_3 --measure (optional)--verbose (optional)--seed=<integer seed> <one or more of the algorithm flags>\n\n"
   #endif
 
   #if defined(ZADANIE4) && ZADANIE4 == 1
-  "(Measuring Run) ./pea_gusta_zadanie_4 --measure (optional)--verbose <one or more of the algorithm flags>\n\n"
+  "(Measuring Run) ./pea_gusta_zadanie_4 --measure (optional)--verbose (optional)--seed=<integer seed> <one or more of the algorithm flags>\n\n"
   #endif
 
   "Flags:\n"
@@ -478,10 +879,12 @@ void help_page() noexcept {
   " -lc: Use Branch and Bound Least Cost algorithm\n"
   " -bb: Use Branch and Bound BFS algorithm\n"
   " -bd: Use Branch and Bound DFS algorithm\n"
+  " -hk: Use Held-Karp dynamic programming algorithm\n"
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
   " -ts: Use Tabu Search algorithm\n"
+  " -ls: Use Local Search algorithm\n"
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -511,11 +914,11 @@ void help_page() noexcept {
 #endif
 
 #if defined(ZADANIE2) && ZADANIE2 == 1
-  "./pea_gusta_zadanie_2 --measure --verbose -bd -bb -lc\n"
+  "./pea_gusta_zadanie_2 --measure --verbose -bd -bb -lc -hk\n"
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
-  "./pea_gusta_zadanie_3 --measure --verbose -ts\n"
+  "./pea_gusta_zadanie_3 --measure --verbose -ts -ls\n"
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -539,6 +942,22 @@ const char** argv) noexcept {
     return vec;
   }()};
 
+  // seed of the random generators for both kinds of runs
+  const auto seed_arg {std::ranges::find_if(arg_vec, [](const std::string& str) {
+    return str.substr(0, 7) == "--seed=";
+  })};
+  std::optional<uint64_t> seed {std::nullopt};
+  if (seed_arg != arg_vec.end()) {
+    uint64_t    value {0};
+    const char* first {seed_arg->data() + 7};
+    const char* last {seed_arg->data() + seed_arg->size()};
+    if (const auto [end, error] {std::from_chars(first, last, value)};
+        error != std::errc {} || end != last || first == last) [[unlikely]] {
+      return tsp::ErrorArg::BAD_ARG;
+    }
+    seed = value;
+  }
+
 #if defined(ZADANIE1) && ZADANIE1 == 1
   const bool algo_nn {std::ranges::find(arg_vec, "-nn") != arg_vec.end()};
   const bool algo_bf {std::ranges::find(arg_vec, "-bf") != arg_vec.end()};
@@ -549,10 +968,12 @@ const char** argv) noexcept {
   const bool algo_bxblc {std::ranges::find(arg_vec, "-lc") != arg_vec.end()};
   const bool algo_bxbbfs {std::ranges::find(arg_vec, "-bb") != arg_vec.end()};
   const bool algo_bxbdfs {std::ranges::find(arg_vec, "-bd") != arg_vec.end()};
+  const bool algo_hk {std::ranges::find(arg_vec, "-hk") != arg_vec.end()};
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
   const bool algo_ts {std::ranges::find(arg_vec, "-ts") != arg_vec.end()};
+  const bool algo_ls {std::ranges::find(arg_vec, "-ls") != arg_vec.end()};
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -567,6 +988,7 @@ const char** argv) noexcept {
     if (std::ranges::find(arg_vec, "--verbose") != arg_vec.end()) {
       run.verbose = true;
     }
+    run.seed = seed;
 
 #if defined(ZADANIE1) && ZADANIE1 == 1
     if (algo_nn) {
@@ -594,12 +1016,20 @@ const char** argv) noexcept {
     if (algo_bxbdfs) {
       run.algorithms.at(5) = tsp::Algorithm::BXB_DFS;
     }
+
+    if (algo_hk) {
+      run.algorithms.at(8) = tsp::Algorithm::HELD_KARP;
+    }
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
     if (algo_ts) {
       run.algorithms.at(6) = tsp::Algorithm::TABU_SEARCH;
     }
+
+    if (algo_ls) {
+      run.algorithms.at(9) = tsp::Algorithm::LOCAL_SEARCH;
+    }
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -644,10 +1074,12 @@ const char** argv) noexcept {
                         &algo_bxblc,
                         &algo_bxbbfs,
                         &algo_bxbdfs,
+                        &algo_hk,
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
                         &algo_ts,
+                        &algo_ls,
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -676,12 +1108,18 @@ const char** argv) noexcept {
     if (algo_bxbdfs) {
       ++count;
     }
+    if (algo_hk) {
+      ++count;
+    }
 #endif
 
 #if defined(ZADANIE3) && ZADANIE3 == 1
     if (algo_ts) {
       ++count;
     }
+    if (algo_ls) {
+      ++count;
+    }
 #endif
 
 #if defined(ZADANIE4) && ZADANIE4 == 1
@@ -703,19 +1141,22 @@ const char** argv) noexcept {
   if (algo_nn) {
     return tsp::SingleRun {
       .algorithm   = tsp::Algorithm::NEAREST_NEIGHBOUR,
-      .config_file = std::filesystem::absolute(config_path)};
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
   }
 
   if (algo_bf) {
     return tsp::SingleRun {
       .algorithm   = tsp::Algorithm::BRUTE_FORCE,
-      .config_file = std::filesystem::absolute(config_path)};
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
   }
 
   if (algo_random) {
     return tsp::SingleRun {
       .algorithm   = tsp::Algorithm::RANDOM,
-      .config_file = std::filesystem::absolute(config_path)};
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
   }
 #endif
 
@@ -723,19 +1164,29 @@ const char** argv) noexcept {
   if (algo_bxblc) {
     return tsp::SingleRun {
       .algorithm   = tsp::Algorithm::BXB_LEAST_COST,
-      .config_file = std::filesystem::absolute(config_path)};
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
   }
 
   if (algo_bxbbfs) {
     return tsp::SingleRun {
       .algorithm   = tsp::Algorithm::BXB_BFS,
-      .config_file = std::filesystem::absolute(config_path)};
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
   }
 
   if (algo_bxbdfs) {
     return tsp::SingleRun {
       .algorithm   = tsp::Algorithm::BXB_DFS,
-      .config_file = std::filesystem::absolute(config_path)};
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
+  }
+
+  if (algo_hk) {
+    return tsp::SingleRun {
+      .algorithm   = tsp::Algorithm::HELD_KARP,
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
   }
 #endif
 
@@ -743,7 +1194,15 @@ const char** argv) noexcept {
   if (algo_ts) {
     return tsp::SingleRun {
       .algorithm   = tsp::Algorithm::TABU_SEARCH,
-      .config_file = std::filesystem::absolute(config_path)};
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
+  }
+
+  if (algo_ls) {
+    return tsp::SingleRun {
+      .algorithm   = tsp::Algorithm::LOCAL_SEARCH,
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
   }
 #endif
 
@@ -751,12 +1210,14 @@ const char** argv) noexcept {
   if (algo_gen) {
     return tsp::SingleRun {
       .algorithm   = tsp::Algorithm::GENETIC,
-      .config_file = std::filesystem::absolute(config_path)};
+      .config_file = std::filesystem::absolute(config_path),
+      .seed        = seed};
   }
 #endif
 
   return tsp::SingleRun {.algorithm   = tsp::Algorithm::INVALID,
-                         .config_file = std::filesystem::absolute(config_path)};
+                         .config_file = std::filesystem::absolute(config_path),
+                         .seed        = seed};
 }
 
 }    // namespace util::arg
@@ -1,91 +1,224 @@
 #include "zadanie_1/bf.hpp"
 
+#include "parallel.hpp"
 #include "util.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <limits>
-#include <queue>
-#include <vector>
+#include <mutex>
 #include <optional>
-#include <variant>
 #include <utility>
+#include <variant>
+#include <vector>
 
 namespace bf::impl {
 
-struct Candidate {
-  int vertex;
-  int cost;
+// count of vertices after the start fixed by every task
+constexpr static int PREFIX_LENGTH {2};
+
+struct SharedBest {
+  std::atomic<int>  cost {std::numeric_limits<int>::max()};
+  std::atomic<bool> stop {false};
+  std::mutex        mutex;
+  tsp::Solution     solution {.path = {}, .cost = 0};
 };
 
-struct WorkingSolution {
+// per worker buffers, allocated once per run
+struct Scratch {
+  std::vector<int>  path;         // path[0] is the start, no closing vertex
+  std::vector<int>  cost_to;      // cost of path[0..i]
   std::vector<bool> used_vertices;
-  tsp::Solution     solution;
 };
 
-static void algorithm(const tsp::Matrix<int>& matrix,
-                      tsp::Solution&          current_best,
-                      int                     starting_vertex) noexcept {
-  const size_t v_count {matrix.size()};
+// like std::next_permutation, returns the first position that changed or -1
+// when the range was the last permutation
+[[nodiscard]] constexpr static int next_permutation(std::vector<int>& path,
+                                                    int first) noexcept {
+  const int last {static_cast<int>(path.size())};
 
-  // potential paths to be processed
-  std::queue<WorkingSolution> queue {
-    {WorkingSolution {.used_vertices =
-                      [&starting_vertex, &v_count]() noexcept {
-                        std::vector<bool> used {};
-                        used.resize(v_count, false);
-                        used.at(starting_vertex) = true;
-                        return used;
-                      }(),
-                      .solution = {.path = {starting_vertex}, .cost = 0}}}};
-
-  while (!queue.empty()) [[likely]] {
-    WorkingSolution current {std::move(queue.front())};
-    queue.pop();
-
-    const int current_v {current.solution.path.back()};
-    const int current_cost {current.solution.cost};
-
-    // if all vertices added check if closed path is better than the best
-    if (current.solution.path.size() == v_count) [[unlikely]] {
-      if (const int return_cost {matrix.at(current_v).at(starting_vertex)};
-          return_cost != -1 && current_cost + return_cost < current_best.cost)
-      [[unlikely]] {
-        current_best       = std::move(current.solution);
-        current_best.cost += return_cost;
-        current_best.path.emplace_back(starting_vertex);
-      }
-    } else [[likely]] {
-      // explore all valid options (not used in current path)
-      std::vector<Candidate> options {};
-      for (int vertex {0}; vertex < v_count; ++vertex) {
-        const bool used {current.used_vertices.at(vertex)};
-
-        if (const int cost {matrix.at(current_v).at(vertex)};
-            !used && cost != -1) [[likely]] {
-          options.emplace_back(Candidate {.vertex = vertex, .cost = cost});
-        }
+  int pivot {last - 2};
+  while (pivot >= first && path[pivot] >= path[pivot + 1]) {
+    --pivot;
+  }
+
+  if (pivot < first) {
+    return -1;
+  }
+
+  int successor {last - 1};
+  while (path[successor] <= path[pivot]) {
+    --successor;
+  }
+
+  std::swap(path[pivot], path[successor]);
+  std::reverse(path.begin() + pivot + 1, path.end());
+
+  return pivot;
+}
+
+// recompute running costs from position first, returns the first position
+// whose incoming edge does not exist or -1
+[[nodiscard]] constexpr static int update_costs(const tsp::CostMatrix& matrix,
+                                                Scratch&               scratch,
+                                                int first) noexcept {
+  const int v_count {static_cast<int>(scratch.path.size())};
+
+  for (int position {std::max(first, 1)}; position < v_count; ++position) {
+    const int cost {
+      matrix(scratch.path[position - 1], scratch.path[position])};
+
+    if (cost == -1) [[unlikely]] {
+      return position;
+    }
+
+    scratch.cost_to[position] = scratch.cost_to[position - 1] + cost;
+  }
+
+  return -1;
+}
+
+static void offer(SharedBest&               best,
+                  const Scratch&            scratch,
+                  int                       cost,
+                  const std::optional<int>& optimal_cost) noexcept {
+  const std::scoped_lock lock {best.mutex};
+
+  if (cost >= best.cost.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  best.solution.path = scratch.path;
+  best.solution.path.emplace_back(scratch.path.front());
+  best.solution.cost = cost;
+  best.cost.store(cost, std::memory_order_relaxed);
+
+  if (optimal_cost.has_value() && cost == *optimal_cost) {
+    best.stop.store(true, std::memory_order_relaxed);
+  }
+}
+
+// decode task index into the vertices at positions 1..prefix_length, the
+// remaining vertices follow in ascending order (first permutation)
+constexpr static void set_prefix(Scratch& scratch,
+                                 int      task,
+                                 int      prefix_length) noexcept {
+  const int v_count {static_cast<int>(scratch.path.size())};
+
+  std::fill(scratch.used_vertices.begin(), scratch.used_vertices.end(), false);
+  scratch.used_vertices[0] = true;
+  scratch.path[0]          = 0;
+
+  int divisor {1};
+  for (int position {1}; position <= prefix_length; ++position) {
+    divisor *= v_count - position;
+  }
+
+  for (int position {1}; position <= prefix_length; ++position) {
+    divisor /= v_count - position;
+    int nth_unused {task / divisor};
+    task %= divisor;
+
+    for (int vertex {1}; vertex < v_count; ++vertex) {
+      if (!scratch.used_vertices[vertex] && nth_unused-- == 0) {
+        scratch.path[position]         = vertex;
+        scratch.used_vertices[vertex] = true;
+        break;
       }
+    }
+  }
 
-      // add next paths to be processed for every valid option
-      for (const auto& option : options) {
-        queue.push([&current, &option]() noexcept {
-          WorkingSolution next_itr {current};
-          next_itr.solution.path.emplace_back(option.vertex);
-          next_itr.solution.cost                   += option.cost;
-          next_itr.used_vertices.at(option.vertex)  = true;
-          return next_itr;
-        }());
+  int position {prefix_length + 1};
+  for (int vertex {1}; vertex < v_count; ++vertex) {
+    if (!scratch.used_vertices[vertex]) {
+      scratch.path[position++] = vertex;
+    }
+  }
+}
+
+// enumerate all permutations of the suffix after the fixed prefix in place
+static void enumerate(const tsp::CostMatrix&    matrix,
+                      Scratch&                  scratch,
+                      SharedBest&               best,
+                      const std::optional<int>& optimal_cost,
+                      int                       task,
+                      int                       prefix_length) noexcept {
+  const int v_count {static_cast<int>(scratch.path.size())};
+  const int first_free {prefix_length + 1};
+
+  set_prefix(scratch, task, prefix_length);
+  scratch.cost_to[0] = 0;
+
+  int changed {1};
+  while (changed != -1) [[likely]] {
+    if (best.stop.load(std::memory_order_relaxed)) [[unlikely]] {
+      return;
+    }
+
+    if (const int broken {update_costs(matrix, scratch, changed)};
+        broken != -1) [[unlikely]] {
+      // nothing with this prefix can be closed, jump to its last permutation
+      if (broken < first_free) {
+        return;
+      }
+      std::sort(scratch.path.begin() + broken + 1,
+                scratch.path.end(),
+                std::greater {});
+    } else if (const int return_cost {
+                 matrix(scratch.path[v_count - 1], scratch.path[0])};
+               return_cost != -1) [[likely]] {
+      const int cost {scratch.cost_to[v_count - 1] + return_cost};
+      if (cost < best.cost.load(std::memory_order_relaxed)) [[unlikely]] {
+        offer(best, scratch, cost, optimal_cost);
       }
     }
+
+    changed = next_permutation(scratch.path, first_free);
   }
 }
 
+// every closed tour passes through vertex 0 so only tours starting there are
+// enumerated, the search space is split across the pool by fixed prefixes
+static void algorithm(const tsp::CostMatrix&    matrix,
+                      SharedBest&               best,
+                      const std::optional<int>& optimal_cost) noexcept {
+  const int v_count {static_cast<int>(matrix.size())};
+  const int prefix_length {std::min(PREFIX_LENGTH, v_count - 1)};
+
+  int task_count {1};
+  for (int position {1}; position <= prefix_length; ++position) {
+    task_count *= v_count - position;
+  }
+
+  util::parallel::ThreadPool& pool {util::parallel::shared_pool()};
+
+  std::vector scratches(pool.size(),
+                        Scratch {.path          = std::vector(v_count, 0),
+                                 .cost_to       = std::vector(v_count, 0),
+                                 .used_vertices = std::vector(v_count, false)});
+
+  pool.run(task_count,
+           [&matrix, &scratches, &best, &optimal_cost, &prefix_length](
+           int worker,
+           int task) noexcept {
+             enumerate(matrix,
+                       scratches[worker],
+                       best,
+                       optimal_cost,
+                       task,
+                       prefix_length);
+           });
+}
+
 }    // namespace bf::impl
 
 namespace bf {
 
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>&   matrix,
-const tsp::GraphInfo&     graph_info,
+const tsp::CostMatrix&    matrix,
+const tsp::GraphInfo&,
 const std::optional<int>& optimal_cost) noexcept {
   const size_t v_count {matrix.size()};
 
@@ -93,24 +226,15 @@ const std::optional<int>& optimal_cost) noexcept {
     return tsp::Solution {.path = {{0}}, .cost = 0};
   }
 
-  tsp::Solution best {.path = {}, .cost = std::numeric_limits<int>::max()};
+  impl::SharedBest best {};
 
-  if (graph_info.full_graph && graph_info.symmetric_graph) {
-    impl::algorithm(matrix, best, 0);
-  } else {
-    for (int vertex {0}; vertex < v_count; ++vertex) {
-      impl::algorithm(matrix, best, vertex);
-      if (optimal_cost.has_value() && *optimal_cost == best.cost) {
-        break;
-      }
-    }
-  }
+  impl::algorithm(matrix, best, optimal_cost);
 
-  if (best.cost == std::numeric_limits<int>::max()) [[unlikely]] {
+  if (best.cost.load() == std::numeric_limits<int>::max()) [[unlikely]] {
     return tsp::ErrorAlgorithm::NO_PATH;
   }
 
-  return best;
+  return std::move(best.solution);
 }
 
 }    // namespace bf
@@ -1,9 +1,12 @@
 #include "zadanie_1/nn.hpp"
 
+#include "parallel.hpp"
 #include "util.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
-#include <queue>
+#include <mutex>
 #include <vector>
 #include <variant>
 #include <optional>
@@ -11,71 +14,281 @@
 
 namespace nn::impl {
 
-struct WorkingSolution {
-  std::vector<bool> used_vertices;
-  tsp::Solution     solution;
+// best tour over all starting vertices, equal costs go to the lower starting
+// vertex as in a serial run, the cost is read without the lock to prune,
+// stop_root is the lowest start that reached the optimum, starts above it
+// are skipped
+struct SharedBest {
+  std::atomic<int> cost {std::numeric_limits<int>::max()};
+  std::atomic<int> stop_root {std::numeric_limits<int>::max()};
+  std::mutex       mutex;
+  int              root {std::numeric_limits<int>::max()};
+  tsp::Solution    solution {.path = {}, .cost = 0};
 };
 
-static void algorithm(const tsp::Matrix<int>& matrix,
-                      tsp::Solution&          current_best,
-                      int                     starting_vertex) noexcept {
+[[nodiscard]] static bool stopped(const SharedBest& best, int root) noexcept {
+  return root >= best.stop_root.load(std::memory_order_relaxed);
+}
+
+// next vertex of one partial tour of the beam, the order breaks cost ties
+// by the older partial tour and then by the lower vertex
+struct Extension {
+  int cost;
+  int parent;
+  int vertex;
+
+  [[nodiscard]] auto operator<=>(const Extension&) const noexcept = default;
+};
+
+// buffers of one worker reused by all its starting vertices, sized once,
+// partial tours of the beam are rows of n vertices and n used flags
+struct Workspace {
+  std::vector<char>      used;
+  std::vector<int>       path;
+  std::vector<int>       paths;
+  std::vector<int>       next_paths;
+  std::vector<char>      used_rows;
+  std::vector<char>      next_used_rows;
+  std::vector<int>       costs;
+  std::vector<int>       next_costs;
+  std::vector<Extension> extensions;    // max heap of the best extensions
+};
+
+[[nodiscard]] static Workspace make_workspace(size_t v_count,
+                                              int    beam_width) noexcept {
+  Workspace work {};
+  work.used.resize(v_count);
+  work.path.resize(v_count);
+  if (beam_width == SINGLE_PATH) {
+    return work;
+  }
+
+  const size_t rows {static_cast<size_t>(beam_width)};
+  work.paths.resize(rows * v_count);
+  work.next_paths.resize(rows * v_count);
+  work.used_rows.resize(rows * v_count);
+  work.next_used_rows.resize(rows * v_count);
+  work.costs.resize(rows);
+  work.next_costs.resize(rows);
+  work.extensions.reserve(rows);
+  return work;
+}
+
+// closed copy of a finished tour if it beats the best one, path[0] is the
+// starting vertex, a tour of one start never replaces an equal one of it
+static void offer(const tsp::CostMatrix&    matrix,
+                  const int*                path,
+                  size_t                    v_count,
+                  int                       cost,
+                  SharedBest&               best,
+                  const std::optional<int>& optimal_cost) noexcept {
+  const int return_cost {matrix(path[v_count - 1], path[0])};
+  if (return_cost == -1 ||
+      cost + return_cost > best.cost.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  const std::scoped_lock lock {best.mutex};
+
+  if (std::pair {cost + return_cost, path[0]} >=
+      std::pair {best.cost.load(std::memory_order_relaxed), best.root}) {
+    return;
+  }
+
+  best.solution.path.assign(path, path + v_count);
+  best.solution.path.emplace_back(path[0]);
+  best.solution.cost = cost + return_cost;
+  best.root          = path[0];
+  best.cost.store(best.solution.cost, std::memory_order_relaxed);
+
+  if (optimal_cost.has_value() && best.solution.cost == *optimal_cost) {
+    best.stop_root.store(best.root, std::memory_order_relaxed);
+  }
+}
+
+// always the cheapest unused successor, ties go to the lower vertex, a dead
+// end, a partial cost above the best or a reached optimum abandons the start,
+// an equal one may still win on the lower start, O(n^2)
+static void greedy(const tsp::CostMatrix&    matrix,
+                   Workspace&                work,
+                   SharedBest&               best,
+                   const std::optional<int>& optimal_cost,
+                   int                       starting_vertex) noexcept {
   const size_t v_count {matrix.size()};
 
-  // potential paths to be processed
-  std::queue<WorkingSolution> queue {
-    {WorkingSolution {.used_vertices =
-                      [&starting_vertex, &v_count]() noexcept {
-                        std::vector used {std::vector(v_count, false)};
-                        used.at(starting_vertex) = true;
-                        return used;
-                      }(),
-                      .solution = {.path = {starting_vertex}, .cost = 0}}}};
-
-  while (!queue.empty()) [[likely]] {
-    WorkingSolution current {std::move(queue.front())};
-    queue.pop();
-
-    const int current_v {current.solution.path.back()};
-    const int current_cost {current.solution.cost};
-
-    // if all vertices added check if closed path is better than the best
-    if (current.solution.path.size() == v_count) [[unlikely]] {
-      if (const int return_cost {matrix.at(current_v).at(starting_vertex)};
-          return_cost != -1 && current_cost + return_cost < current_best.cost)
-      [[unlikely]] {
-        current_best       = std::move(current.solution);
-        current_best.cost += return_cost;
-        current_best.path.emplace_back(starting_vertex);
+  std::ranges::fill(work.used, 0);
+  work.path[0]               = starting_vertex;
+  work.used[starting_vertex] = 1;
+
+  int cost {0};
+  for (size_t step {1}; step < v_count; ++step) {
+    const int* const row {matrix.row(work.path[step - 1])};
+
+    int next {-1};
+    int next_cost {std::numeric_limits<int>::max()};
+    for (int vertex {0}; vertex < v_count; ++vertex) {
+      if (work.used[vertex] == 0 && row[vertex] != -1 &&
+          row[vertex] < next_cost) [[unlikely]] {
+        next      = vertex;
+        next_cost = row[vertex];
       }
-    } else [[likely]] {
-      // explore all adjacent vertices which cost minimal cost to travel to
-      std::vector<int> nearest {};
-      int              min_cost {std::numeric_limits<int>::max()};
+    }
+
+    if (next == -1) [[unlikely]] {
+      return;
+    }
+    cost += next_cost;
+    if (cost > best.cost.load(std::memory_order_relaxed) ||
+        stopped(best, starting_vertex)) [[unlikely]] {
+      return;
+    }
+
+    work.path[step] = next;
+    work.used[next] = 1;
+  }
+
+  offer(matrix, work.path.data(), v_count, cost, best, optimal_cost);
+}
+
+// the beam_width cheapest partial tours survive every step, one extension
+// per unused successor of each, rows are kept sorted so pruning by the
+// shared best only drops the most expensive ones and never renumbers the
+// rest, O(beam_width * n^2)
+static void beam(const tsp::CostMatrix&    matrix,
+                 Workspace&                work,
+                 SharedBest&               best,
+                 const std::optional<int>& optimal_cost,
+                 int                       starting_vertex,
+                 int                       beam_width) noexcept {
+  const size_t v_count {matrix.size()};
+  const size_t width {static_cast<size_t>(beam_width)};
+
+  size_t rows {1};
+  work.paths[0] = starting_vertex;
+  std::fill_n(work.used_rows.begin(), v_count, 0);
+  work.used_rows[starting_vertex] = 1;
+  work.costs[0]                   = 0;
+
+  for (size_t step {1}; step < v_count; ++step) {
+    if (stopped(best, starting_vertex)) [[unlikely]] {
+      return;
+    }
+
+    const int bound {best.cost.load(std::memory_order_relaxed)};
+    work.extensions.clear();
+
+    for (size_t parent {0}; parent < rows; ++parent) {
+      const int* const  row {
+        matrix.row(work.paths[parent * v_count + step - 1])};
+      const char* const used {work.used_rows.data() + parent * v_count};
+
       for (int vertex {0}; vertex < v_count; ++vertex) {
-        const bool used {current.used_vertices.at(vertex)};
-
-        if (const int cost {matrix.at(current_v).at(vertex)};
-            !used && cost != -1 && cost <= min_cost) [[unlikely]] {
-          if (cost < min_cost) [[unlikely]] {
-            nearest.clear();
-            min_cost = cost;
-          }
-          nearest.emplace_back(vertex);
+        if (used[vertex] != 0 || row[vertex] == -1) {
+          continue;
+        }
+
+        const Extension extension {.cost   = work.costs[parent] + row[vertex],
+                                   .parent = static_cast<int>(parent),
+                                   .vertex = vertex};
+        if (extension.cost > bound) {
+          continue;
         }
-      }
 
-      // add next paths to be processed for nearest neighbour
-      for (const auto& option : nearest) {
-        queue.push([&current, &option, &min_cost]() noexcept {
-          WorkingSolution next_itr {current};
-          next_itr.solution.path.emplace_back(option);
-          next_itr.solution.cost            += min_cost;
-          next_itr.used_vertices.at(option)  = true;
-          return next_itr;
-        }());
+        if (work.extensions.size() < width) {
+          work.extensions.push_back(extension);
+          std::ranges::push_heap(work.extensions);
+        } else if (extension < work.extensions.front()) {
+          std::ranges::pop_heap(work.extensions);
+          work.extensions.back() = extension;
+          std::ranges::push_heap(work.extensions);
+        }
       }
     }
+
+    if (work.extensions.empty()) [[unlikely]] {
+      return;
+    }
+    std::ranges::sort_heap(work.extensions);
+
+    for (size_t i {0}; i < work.extensions.size(); ++i) {
+      const Extension& extension {work.extensions[i]};
+      const size_t     parent {static_cast<size_t>(extension.parent)};
+
+      std::copy_n(work.paths.begin() + parent * v_count,
+                  step,
+                  work.next_paths.begin() + i * v_count);
+      work.next_paths[i * v_count + step] = extension.vertex;
+
+      std::copy_n(work.used_rows.begin() + parent * v_count,
+                  v_count,
+                  work.next_used_rows.begin() + i * v_count);
+      work.next_used_rows[i * v_count + extension.vertex] = 1;
+
+      work.next_costs[i] = extension.cost;
+    }
+
+    rows = work.extensions.size();
+    std::swap(work.paths, work.next_paths);
+    std::swap(work.used_rows, work.next_used_rows);
+    std::swap(work.costs, work.next_costs);
   }
+
+  for (size_t i {0}; i < rows; ++i) {
+    offer(matrix,
+          work.paths.data() + i * v_count,
+          v_count,
+          work.costs[i],
+          best,
+          optimal_cost);
+  }
+}
+
+static void from_vertex(const tsp::CostMatrix&    matrix,
+                        Workspace&                work,
+                        SharedBest&               best,
+                        const std::optional<int>& optimal_cost,
+                        int                       starting_vertex,
+                        int                       beam_width) noexcept {
+  // the greedy path first, the beam only has to beat it and is pruned by it,
+  // partial costs rank the beam so it alone can end worse than greedy
+  greedy(matrix, work, best, optimal_cost, starting_vertex);
+  if (beam_width != SINGLE_PATH) {
+    beam(matrix, work, best, optimal_cost, starting_vertex, beam_width);
+  }
+}
+
+// every starting vertex is a task of the pool, workers share the best cost
+// for pruning and skip the starts above the one that found the optimum,
+// workspaces are allocated by the first start of each worker
+static void algorithm(const tsp::CostMatrix&    matrix,
+                      SharedBest&               best,
+                      const std::optional<int>& optimal_cost,
+                      int                       start_count,
+                      int                       beam_width) noexcept {
+  util::parallel::ThreadPool& pool {util::parallel::shared_pool()};
+
+  std::vector<Workspace> works(pool.size());
+
+  pool.run(start_count,
+           [&matrix, &works, &best, &optimal_cost, &beam_width](
+           int worker,
+           int starting_vertex) noexcept {
+             if (stopped(best, starting_vertex)) [[unlikely]] {
+               return;
+             }
+
+             Workspace& work {works[worker]};
+             if (work.used.empty()) [[unlikely]] {
+               work = make_workspace(matrix.size(), beam_width);
+             }
+
+             from_vertex(matrix,
+                         work,
+                         best,
+                         optimal_cost,
+                         starting_vertex,
+                         beam_width);
+           });
 }
 
 }    // namespace nn::impl
@@ -83,33 +296,36 @@ static void algorithm(const tsp::Matrix<int>& matrix,
 namespace nn {
 
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>&   matrix,
+const tsp::CostMatrix&    matrix,
 const tsp::GraphInfo&     graph_info,
-const std::optional<int>& optimal_cost) noexcept {
+const std::optional<int>& optimal_cost,
+const int                 beam_width) noexcept {
   const size_t v_count {matrix.size()};
 
+  if (beam_width < 1) [[unlikely]] {
+    return tsp::ErrorAlgorithm::INVALID_PARAM;
+  }
+
   if (v_count == 1) [[unlikely]] {    //edge case: 1 vertex
     return tsp::Solution {.path = {{0}}, .cost = 0};
   }
 
-  tsp::Solution best {.path = {}, .cost = std::numeric_limits<int>::max()};
+  impl::SharedBest best {};
 
+  // a full symmetric graph needs only vertex 0 as the start
   if (graph_info.full_graph && graph_info.symmetric_graph) {
-    impl::algorithm(matrix, best, 0);
+    impl::Workspace work {impl::make_workspace(v_count, beam_width)};
+    impl::from_vertex(matrix, work, best, optimal_cost, 0, beam_width);
   } else {
-    for (int vertex {0}; vertex < v_count; ++vertex) {
-      impl::algorithm(matrix, best, vertex);
-      if (optimal_cost.has_value() && *optimal_cost == best.cost) {
-        break;
-      }
-    }
+    impl::algorithm(
+    matrix, best, optimal_cost, static_cast<int>(v_count), beam_width);
   }
 
-  if (best.cost == std::numeric_limits<int>::max()) [[unlikely]] {
+  if (best.cost.load() == std::numeric_limits<int>::max()) [[unlikely]] {
     return tsp::ErrorAlgorithm::NO_PATH;
   }
 
-  return best;
+  return std::move(best.solution);
 }
 
 }    // namespace nn
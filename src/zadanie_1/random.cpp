@@ -1,99 +1,115 @@
 #include "zadanie_1/random.hpp"
 
+#include "anytime.hpp"
+#include "rng.hpp"
 #include "util.hpp"
 
+#include <algorithm>
 #include <limits>
-#include <random>
 #include <vector>
 #include <variant>
 #include <optional>
-#include <chrono>
 #include <utility>
 #include <cstddef>
+#include <cstdint>
 
 namespace random::impl {
 
-struct WorkingSolution {
-  std::vector<bool> used_vertices;
-  tsp::Solution     solution;
+// one tour buffer reused by every sample, order[0, placed) is the tour so
+// far and order[placed, n) the vertices still free, so no sample allocates
+struct Sampler {
+  util::rng::Xoshiro256 engine;
+  std::vector<int>      order;
 };
 
-struct RandomSource {
-  std::mt19937_64                    engine;
-  std::uniform_int_distribution<> dist;
-};
-
-constexpr static int NUMBER_OF_RETRIES {1'0000};
-
-constexpr static void algorithm(const tsp::Matrix<int>& matrix,
-                                const tsp::GraphInfo&   graph_info,
-                                RandomSource&           random_source,
-                                tsp::Solution&          current_best) noexcept {
-  const size_t v_count {matrix.size()};
-
-  WorkingSolution work {
-    .used_vertices = std::vector(v_count, false),
-    .solution      = {.path = {}, .cost = 0}
-  };
-
-  work.solution.path.emplace_back(random_source.dist(random_source.engine));
-  work.used_vertices.at(work.solution.path.front()) = true;
-
-  while (work.solution.path.size() != v_count) [[likely]] {
-    const size_t starting_size {work.solution.path.size()};
-
-    if (!graph_info.full_graph) {
-      // check if path exists
-      bool has_path {false};
-      for (int vertex {0}; vertex < v_count; ++vertex) {
-        if (matrix.at(work.solution.path.back()).at(vertex) != -1) [[likely]] {
-          has_path = true;
-          break;
-        }
-      }
+// fisher-yates shuffle, every permutation equally likely, cost summed while
+// the tour is drawn, -1 if an edge is missing, O(n)
+[[nodiscard]] static int sample_full(const tsp::CostMatrix& matrix,
+                                     Sampler&               sampler) noexcept {
+  const uint32_t v_count {static_cast<uint32_t>(sampler.order.size())};
+  int* const     order {sampler.order.data()};
+
+  int cost {0};
+  for (uint32_t placed {0}; placed < v_count; ++placed) {
+    std::swap(order[placed],
+              order[placed + sampler.engine.below(v_count - placed)]);
+    if (placed == 0) [[unlikely]] {
+      continue;
+    }
 
-      if (!has_path) [[unlikely]] {
-        return;
-      }
+    const int edge_cost {matrix(order[placed - 1], order[placed])};
+    if (edge_cost == -1) [[unlikely]] {
+      return -1;
     }
+    cost += edge_cost;
+  }
 
-    // while did not rand valid vertex generate, then add valid random vertex
-    for (int i {0}; i < NUMBER_OF_RETRIES; ++i) {
-      const int  random_v {random_source.dist(random_source.engine)};
-      const bool used {work.used_vertices.at(random_v)};
+  const int return_cost {matrix(order[v_count - 1], order[0])};
+  if (return_cost == -1) [[unlikely]] {
+    return -1;
+  }
+  return cost + return_cost;
+}
 
-      if (const int cost {matrix.at(work.solution.path.back()).at(random_v)};
-          !used && cost != -1) {
-        work.solution.path.emplace_back(random_v);
-        work.solution.cost              += cost;
-        work.used_vertices.at(random_v)  = true;
+// draws of a free vertex before the free vertices are scanned for reachable
+// ones, a rejected draw costs O(1) and a scan O(n)
+constexpr static int SPARSE_DRAWS {8};
+
+// fisher-yates restricted to the free vertices reachable from the last one,
+// a uniform free vertex is redrawn until it is reachable (uniform among the
+// reachable ones), after SPARSE_DRAWS misses they are counted and a uniform
+// one is taken, a dead end fails the sample, O(n) on dense graphs and
+// O(n^2) at worst
+[[nodiscard]] static int sample_sparse(const tsp::CostMatrix& matrix,
+                                       Sampler&               sampler) noexcept {
+  const uint32_t v_count {static_cast<uint32_t>(sampler.order.size())};
+  int* const     order {sampler.order.data()};
+
+  std::swap(order[0], order[sampler.engine.below(v_count)]);
+
+  int cost {0};
+  for (uint32_t placed {1}; placed < v_count; ++placed) {
+    const int* const row {matrix.row(order[placed - 1])};
+
+    uint32_t chosen {v_count};
+    for (int draw {0}; draw < SPARSE_DRAWS; ++draw) {
+      const uint32_t candidate {placed +
+                                sampler.engine.below(v_count - placed)};
+      if (row[order[candidate]] != -1) [[likely]] {
+        chosen = candidate;
         break;
       }
     }
 
-    // no path found in max retries
-    if (starting_size == work.solution.path.size()) [[unlikely]] {
-      return;
-    }
-  }
+    if (chosen == v_count) [[unlikely]] {
+      uint32_t reachable {0};
+      for (uint32_t i {placed}; i < v_count; ++i) {
+        reachable += static_cast<uint32_t>(row[order[i]] != -1);
+      }
+      if (reachable == 0) [[unlikely]] {
+        return -1;
+      }
 
-  if (!graph_info.full_graph) {
-    // edge case: no path from last to beginning
-    if (matrix.at(work.solution.path.back()).at(work.solution.path.front()) == -1)
-      [[unlikely]] {
-        return;
+      uint32_t pick {sampler.engine.below(reachable)};
+      for (chosen = placed;; ++chosen) {
+        if (row[order[chosen]] != -1) {
+          if (pick == 0) {
+            break;
+          }
+          --pick;
+        }
       }
-  }
+    }
 
-  // add cost to travel to beginning from last
-  work.solution.cost +=
-  matrix.at(work.solution.path.back()).at(work.solution.path.front());
+    std::swap(order[placed], order[chosen]);
+    cost += row[order[placed]];
+  }
 
-  // if generated path would have better cost than current best close it and set new current best
-  if (work.solution.cost < current_best.cost) [[unlikely]] {
-    current_best = std::move(work.solution);
-    current_best.path.emplace_back(current_best.path.front());
+  const int return_cost {matrix(order[v_count - 1], order[0])};
+  if (return_cost == -1) [[unlikely]] {
+    return -1;
   }
+  return cost + return_cost;
 }
 
 }    // namespace random::impl
@@ -101,12 +117,10 @@ constexpr static void algorithm(const tsp::Matrix<int>& matrix,
 namespace random {
 
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>&   matrix,
+const tsp::CostMatrix&    matrix,
 const tsp::GraphInfo&     graph_info,
 const std::optional<int>& optimal_cost,
 const int                 time_ms) noexcept {
-  const auto start {std::chrono::high_resolution_clock::now()};
-
   if (time_ms < 1) {
     return tsp::ErrorAlgorithm::INVALID_PARAM;
   }
@@ -117,24 +131,38 @@ const int                 time_ms) noexcept {
     return tsp::Solution {.path = {{0}}, .cost = 0};
   }
 
-  std::random_device device {};
-  impl::RandomSource random_source {
-    .engine = std::mt19937_64 {device()},
-    .dist   = std::uniform_int_distribution {0, static_cast<int>(v_count - 1)}
-  };
+  const util::anytime::Deadline deadline {time_ms};
 
-  tsp::Solution best {.path = {}, .cost = std::numeric_limits<int>::max()};
+  impl::Sampler sampler {.engine = util::rng::stream(0),
+                         .order  = std::vector<int>(v_count)};
+  for (int vertex {0}; vertex < v_count; ++vertex) {
+    sampler.order[vertex] = vertex;
+  }
+
+  tsp::Solution best {.path = std::vector<int>(v_count + 1),
+                      .cost = std::numeric_limits<int>::max()};
 
-  // run for specified time
-  while (true) {
-    const tsp::Time elapsed {std::chrono::high_resolution_clock::now() - start};
-    if (elapsed.count() > time_ms) {
+  // run for specified time, the clock is read every CHECK_INTERVAL samples
+  for (int sample {0};;
+       sample = (sample + 1) % util::anytime::Deadline::CHECK_INTERVAL) {
+    if (deadline.passed(sample)) [[unlikely]] {
       break;
     }
 
-    impl::algorithm(matrix, graph_info, random_source, best);
-    if (optimal_cost.has_value() && *optimal_cost == best.cost) {
-      break;
+    const int cost {graph_info.full_graph
+                    ? impl::sample_full(matrix, sampler)
+                    : impl::sample_sparse(matrix, sampler)};
+
+    // if sampled path is better than current best copy it and close it
+    if (cost != -1 && cost < best.cost) [[unlikely]] {
+      std::copy(sampler.order.begin(), sampler.order.end(), best.path.begin());
+      best.path[v_count] = best.path[0];
+      best.cost          = cost;
+      util::anytime::record(cost);
+
+      if (optimal_cost.has_value() && *optimal_cost == best.cost) {
+        break;
+      }
     }
   }
 
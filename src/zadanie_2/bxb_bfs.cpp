@@ -1,5 +1,7 @@
 #include "zadanie_2/bxb_bfs.hpp"
-#include "zadanie_1/nn.hpp"
+#include "zadanie_2/bxb_bound.hpp"
+#include "zadanie_2/bxb_node.hpp"
+#include "construct.hpp"
 #include "util.hpp"
 
 #include <cstddef>
@@ -12,78 +14,116 @@
 
 namespace bxb::bfs::impl {
 
-struct WorkingSolution {
-  std::vector<bool> used_vertices;
-  tsp::Solution     solution;
-};
-
-constexpr static std::vector<WorkingSolution> branch(
-const tsp::Matrix<int>& matrix,
-const WorkingSolution&  node,
-int                     max_cost) noexcept {
+constexpr static bound::Kind BOUND_KIND {bound::Kind::REDUCTION};
+
+// appends viable children of the node to the queue, false once the arena
+// is full
+template<size_t Words>
+[[nodiscard]] static bool branch(
+const tsp::CostMatrix&         matrix,
+bound::Engine&                 bound_engine,
+node::Arena&                   arena,
+const node::Node<Words>&       node,
+int                            max_cost,
+std::queue<node::Node<Words>>& bfs_queue) noexcept {
   const size_t v_count {matrix.size()};
 
-  std::vector<WorkingSolution> children {};
-
   for (int candidate {0}; candidate < v_count; ++candidate) {
-    if (const int cost {matrix.at(node.solution.path.back()).at(candidate)};
-        !node.used_vertices.at(candidate) && cost != -1 &&
-        node.solution.cost + cost < max_cost) [[likely]] {
-      children.emplace_back([&candidate, &node, &cost]() noexcept {
-        WorkingSolution next {node};
-        next.solution.path.emplace_back(candidate);
-        next.solution.cost               += cost;
-        next.used_vertices.at(candidate)  = true;
-        return next;
-      }());
+    const int cost {matrix(node.last, candidate)};
+    if (node.visited.test(candidate) || cost == -1) {
+      continue;
+    }
+
+    // bound the cheapest tour that could still follow this child
+    const bound::Remainder remainder {
+      bound_engine.child(node.remainder, node.last, candidate)};
+    const int lower_bound {bound_engine.evaluate(
+    [&node, &candidate](int vertex) noexcept {
+      return vertex == candidate || node.visited.test(vertex);
+    },
+    node.last,
+    candidate,
+    node.cost + cost,
+    remainder,
+    node.potentials,
+    max_cost)};
+
+    if (lower_bound < max_cost) [[likely]] {
+      const node::Link link {arena.append(node.link, candidate)};
+      if (link == node::NO_LINK) [[unlikely]] {
+        return false;
+      }
+
+      node::Node<Words> next {.visited     = node.visited,
+                              .remainder   = remainder,
+                              .potentials  = bound_engine.potentials(),
+                              .link        = link,
+                              .last        = candidate,
+                              .cost        = node.cost + cost,
+                              .lower_bound = lower_bound,
+                              .depth       = node.depth + 1};
+      next.visited.set(candidate);
+      bfs_queue.push(std::move(next));
     }
   }
 
-  return children;
+  return true;
 }
 
-static void algorithm(const tsp::Matrix<int>& matrix,
-                      tsp::Solution&          current_best,
-                      int                     starting_vertex) {
+// false if the arena filled up before the search finished
+template<size_t Words>
+[[nodiscard]] static bool algorithm(const tsp::CostMatrix& matrix,
+                                    tsp::Solution&         current_best,
+                                    int                    starting_vertex) {
   const size_t v_count {matrix.size()};
 
-  std::queue<WorkingSolution> bfs_queue {
-    {WorkingSolution {.used_vertices =
-                      [&starting_vertex, &v_count]() noexcept {
-                        std::vector root_used_v {std::vector(v_count, false)};
-                        root_used_v.at(starting_vertex) = true;
-                        return root_used_v;
-                      }(),
-                      .solution = {.path = {starting_vertex}, .cost = 0}}}};
+  bound::Engine bound_engine {matrix, starting_vertex, BOUND_KIND};
+  node::Arena   arena {};
+
+  std::queue<node::Node<Words>> bfs_queue {};
+  bfs_queue.push([&]() noexcept {
+    node::Node<Words> root {.visited     = {},
+                            .remainder   = bound_engine.root(),
+                            .potentials  = bound_engine.root_potentials(),
+                            .link        = arena.append(node::NO_LINK,
+                                                 starting_vertex),
+                            .last        = starting_vertex,
+                            .cost        = 0,
+                            .lower_bound = 0,
+                            .depth       = 1};
+    root.visited.set(starting_vertex);
+    return root;
+  }());
 
   while (!bfs_queue.empty()) [[likely]] {
-    WorkingSolution node {std::move(bfs_queue.front())};
+    const node::Node<Words> node {std::move(bfs_queue.front())};
     bfs_queue.pop();
 
-    const int current_v {node.solution.path.back()};
-    const int current_cost {node.solution.cost};
-
-    // do not explore if already worse or equal
-    if (current_cost >= current_best.cost) [[unlikely]] {
+    // do not explore if can not be better
+    if (node.lower_bound >= current_best.cost) [[unlikely]] {
       continue;
     }
 
     // if leaf add return and compare with best, if no return path ignore
-    if (node.solution.path.size() == v_count) [[unlikely]] {
-      if (const int return_cost {matrix.at(current_v).at(starting_vertex)};
-          return_cost != -1 && current_cost + return_cost < current_best.cost)
+    if (node.depth == v_count) [[unlikely]] {
+      if (const int return_cost {matrix(node.last, starting_vertex)};
+          return_cost != -1 && node.cost + return_cost < current_best.cost)
       [[unlikely]] {
-        current_best       = std::move(node.solution);
-        current_best.cost += return_cost;
+        current_best.path = arena.path(node.link, node.depth);
         current_best.path.emplace_back(starting_vertex);
+        current_best.cost = node.cost + return_cost;
       }
     } else [[likely]] {
-      // if not leaf add viable children to priority queue
-      for (const auto& child : branch(matrix, node, current_best.cost)) {
-        bfs_queue.emplace(child);
+      // if not leaf add viable children to the queue
+      if (!branch(
+          matrix, bound_engine, arena, node, current_best.cost, bfs_queue))
+      [[unlikely]] {
+        return false;
       }
     }
   }
+
+  return true;
 }
 
 }    // namespace bxb::bfs::impl
@@ -91,30 +131,37 @@ static void algorithm(const tsp::Matrix<int>& matrix,
 namespace bxb::bfs {
 
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>&   matrix,
+const tsp::CostMatrix&    matrix,
 const tsp::GraphInfo&     graph_info,
-const std::optional<int>& optimal_cost) noexcept {
+const std::optional<int>& optimal_cost,
+const tsp::Construction   initial) noexcept {
   const size_t v_count {matrix.size()};
 
   if (v_count == 1) [[unlikely]] {    //edge case: 1 vertex
     return tsp::Solution {.path = {{0}}, .cost = 0};
   }
 
-  // upper bound = nn solution
-  auto upper_bound_result {nn::run(matrix, graph_info, optimal_cost)};
+  // upper bound = tour of the chosen construction heuristic
+  auto upper_bound_result {
+    util::construct::tour(matrix, graph_info, optimal_cost, initial)};
   if (std::holds_alternative<tsp::ErrorAlgorithm>(upper_bound_result)) {
     return upper_bound_result;
   }
   tsp::Solution best {std::move(std::get<tsp::Solution>(upper_bound_result))};
 
-  if (graph_info.full_graph && graph_info.symmetric_graph) {
-    impl::algorithm(matrix, best, 0);
-  } else {
-    for (int vertex {0}; vertex < v_count; ++vertex) {
-      impl::algorithm(matrix, best, vertex);
-      if (optimal_cost.has_value() && best.cost == *optimal_cost) {
-        break;
-      }
+  // the search is exact and every tour passes through vertex 0, so no other
+  // starting vertex has to be searched
+  if (!optimal_cost.has_value() || best.cost != *optimal_cost) {
+    if (!node::fits(v_count)) [[unlikely]] {
+      return tsp::ErrorAlgorithm::TOO_LARGE;
+    }
+    bool finished {true};
+    node::dispatch(
+    v_count, [&matrix, &best, &finished]<size_t Words>() noexcept {
+      finished = impl::algorithm<Words>(matrix, best, 0);
+    });
+    if (!finished) [[unlikely]] {
+      return tsp::ErrorAlgorithm::TOO_LARGE;
     }
   }
 
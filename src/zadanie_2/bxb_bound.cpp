@@ -0,0 +1,185 @@
+#include "zadanie_2/bxb_bound.hpp"
+
+#include "util.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace bxb::bound::impl {
+
+constexpr static int NONE {std::numeric_limits<int>::max()};
+
+}    // namespace bxb::bound::impl
+
+namespace bxb::bound {
+
+Engine::Engine(const tsp::CostMatrix& matrix,
+               const int              starting_vertex,
+               const Kind             kind) noexcept:
+  matrix {&matrix},
+  start {starting_vertex},
+  kind {kind},
+  min_out(matrix.size(), impl::NONE),
+  min_in(matrix.size(), impl::NONE),
+  scratch {.values = {}, .total = 0} {
+  const size_t v_count {matrix.size()};
+
+  for (size_t from {0}; from < v_count; ++from) {
+    for (size_t to {0}; to < v_count; ++to) {
+      if (const int cost {matrix(from, to)}; from != to && cost != -1) {
+        min_out.at(from) = std::min(min_out.at(from), cost);
+        min_in.at(to)    = std::min(min_in.at(to), cost);
+      }
+    }
+  }
+
+  // a vertex without edges makes the instance unsolvable, that is reported
+  // by the upper bound, here it only must not overflow the sums
+  for (size_t vertex {0}; vertex < v_count; ++vertex) {
+    if (min_out.at(vertex) == impl::NONE) [[unlikely]] {
+      min_out.at(vertex) = 0;
+    }
+    if (min_in.at(vertex) == impl::NONE) [[unlikely]] {
+      min_in.at(vertex) = 0;
+    }
+  }
+
+  remaining.reserve(v_count);
+  scratch.values.reserve(2 * v_count);
+}
+
+Remainder Engine::root() const noexcept {
+  return {.out = std::accumulate(min_out.begin(), min_out.end(), 0),
+          .in  = std::accumulate(min_in.begin(), min_in.end(), 0)};
+}
+
+Potentials Engine::root_potentials() const noexcept {
+  if (kind != Kind::REDUCTION) {
+    return {.values = {}, .total = 0};
+  }
+
+  const tsp::CostMatrix& cost {*matrix};
+  const size_t           v_count {cost.size()};
+
+  // every row is still to be left and every column entered, row minima are
+  // the cheapest outgoing edges
+  Potentials root {.values = std::vector<int>(2 * v_count, 0), .total = 0};
+  int* const row_potential {root.values.data()};
+  int* const column_potential {row_potential + v_count};
+
+  for (size_t from {0}; from < v_count; ++from) {
+    row_potential[from]  = min_out.at(from);
+    root.total          += row_potential[from];
+  }
+
+  for (size_t to {0}; to < v_count; ++to) {
+    int minimum {impl::NONE};
+    for (size_t from {0}; from < v_count; ++from) {
+      if (const int edge {cost(from, to)}; from != to && edge != -1) {
+        minimum = std::min(minimum, edge - row_potential[from]);
+      }
+    }
+    if (minimum != impl::NONE) [[likely]] {
+      column_potential[to]  = minimum;
+      root.total           += minimum;
+    }
+  }
+
+  return root;
+}
+
+int Engine::reduce(const std::span<const int> remaining_v,
+                   const Potentials&          parent,
+                   const int                  from,
+                   const int                  to,
+                   const int                  max_extra) noexcept {
+  const tsp::CostMatrix& cost {*matrix};
+  const size_t           v_count {cost.size()};
+
+  // rows: to then remaining, columns: remaining then start, the row and
+  // column left out keep their potentials but are no longer summed
+  scratch.values.assign(parent.values.begin(), parent.values.end());
+  int* const row_potential {scratch.values.data()};
+  int* const column_potential {row_potential + v_count};
+  int        total {parent.total - row_potential[from] - column_potential[to]};
+
+  // reduced cost of an edge the child may still use, to can not return to
+  // start yet
+  const auto reduced {[&](const int tail, const int head) noexcept {
+    const int edge {cost(tail, head)};
+    if (tail == head || edge == -1 || (tail == to && head == start)) {
+      return impl::NONE;
+    }
+    return edge - row_potential[tail] - column_potential[head];
+  }};
+
+  const auto reduce_row {[&](const int tail) noexcept {
+    int minimum {reduced(tail, start)};
+    for (const int head : remaining_v) {
+      minimum = std::min(minimum, reduced(tail, head));
+    }
+    if (minimum == impl::NONE) [[unlikely]] {
+      return false;
+    }
+    row_potential[tail] += minimum;
+    total               += minimum;
+    return true;
+  }};
+
+  const auto reduce_column {[&](const int head) noexcept {
+    int minimum {reduced(to, head)};
+    for (const int tail : remaining_v) {
+      minimum = std::min(minimum, reduced(tail, head));
+    }
+    if (minimum == impl::NONE) [[unlikely]] {
+      return false;
+    }
+    column_potential[head] += minimum;
+    total                  += minimum;
+    return true;
+  }};
+
+  // every row and column of the parent had a zero, the child only loses the
+  // zeros in row from, in column to and on the to -> start edge
+  const int  closed_edge {cost(to, start)};
+  const bool closed_zero {closed_edge != -1 &&
+                          closed_edge == row_potential[to] +
+                                         column_potential[start]};
+
+  if (total >= max_extra) {
+    return total;
+  }
+
+  if (closed_zero && !reduce_row(to)) [[unlikely]] {
+    return impl::NONE;
+  }
+  for (const int tail : remaining_v) {
+    if (reduced(tail, to) == 0 && !reduce_row(tail)) [[unlikely]] {
+      return impl::NONE;
+    }
+    if (total >= max_extra) {
+      return total;
+    }
+  }
+
+  if (closed_zero && !reduce_column(start)) [[unlikely]] {
+    return impl::NONE;
+  }
+  for (const int head : remaining_v) {
+    if (reduced(from, head) == 0 && !reduce_column(head)) [[unlikely]] {
+      return impl::NONE;
+    }
+    if (total >= max_extra) {
+      return total;
+    }
+  }
+
+  scratch.total = total;
+  return total;
+}
+
+}    // namespace bxb::bound
@@ -1,10 +1,12 @@
 #include "zadanie_2/bxb_dfs.hpp"
-#include "zadanie_1/nn.hpp"
+#include "zadanie_2/bxb_bound.hpp"
+#include "zadanie_2/bxb_node.hpp"
+#include "construct.hpp"
 #include "util.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <limits>
-#include <stack>
 #include <vector>
 #include <optional>
 #include <variant>
@@ -12,78 +14,131 @@
 
 namespace bxb::dfs::impl {
 
-struct WorkingSolution {
-  std::vector<bool> used_vertices;
-  tsp::Solution     solution;
+constexpr static bound::Kind BOUND_KIND {bound::Kind::REDUCTION};
+
+struct Child {
+  bound::Remainder  remainder;
+  bound::Potentials potentials;
+  int               vertex;
+  int               edge_cost;
+  int               lower_bound;
 };
 
-constexpr static std::vector<WorkingSolution> branch(
-const tsp::Matrix<int>& matrix,
-const WorkingSolution&  node,
-int                     max_cost) noexcept {
-  const size_t v_count {matrix.size()};
+// depth first search over a single path extended and retracted in place,
+// all buffers are sized once and child slots keep their potentials, so
+// descending allocates only while the slots are first filled
+template<size_t Words>
+class Search {
+public:
+  Search(const tsp::CostMatrix& matrix,
+         tsp::Solution&         current_best,
+         int                    starting_vertex) noexcept:
+    matrix {matrix},
+    current_best {current_best},
+    bound_engine {matrix, starting_vertex, BOUND_KIND},
+    v_count {static_cast<int>(matrix.size())},
+    path(v_count),
+    children(static_cast<size_t>(v_count) * v_count) {
+    path.at(0) = starting_vertex;
+    visited.set(starting_vertex);
+  }
 
-  std::vector<WorkingSolution> children {};
-
-  for (int candidate {0}; candidate < v_count; ++candidate) {
-    if (const int cost {matrix.at(node.solution.path.back()).at(candidate)};
-        !node.used_vertices.at(candidate) && cost != -1 &&
-        node.solution.cost + cost < max_cost) [[likely]] {
-      children.emplace_back([&candidate, &node, &cost]() noexcept {
-        WorkingSolution next {node};
-        next.solution.path.emplace_back(candidate);
-        next.solution.cost               += cost;
-        next.used_vertices.at(candidate)  = true;
-        return next;
-      }());
-    }
+  void run() noexcept {
+    descend(1, 0, bound_engine.root(), bound_engine.root_potentials());
   }
 
-  return children;
-}
+private:
+  void descend(int                      depth,
+               int                      cost,
+               const bound::Remainder&  remainder,
+               const bound::Potentials& potentials) noexcept {
+    const int last {path[depth - 1]};
 
-static void algorithm(const tsp::Matrix<int>& matrix,
-                      tsp::Solution&          current_best,
-                      int                     starting_vertex) {
-  const size_t v_count {matrix.size()};
+    // if leaf add return and compare with best, if no return path ignore
+    if (depth == v_count) [[unlikely]] {
+      if (const int return_cost {matrix(last, path[0])};
+          return_cost != -1 && cost + return_cost < current_best.cost) {
+        current_best.path.assign(path.begin(), path.end());
+        current_best.path.emplace_back(path[0]);
+        current_best.cost = cost + return_cost;
+      }
+      return;
+    }
+
+    // children of this depth live in their own slice of the buffer
+    Child* const first {children.data() +
+                        static_cast<size_t>(depth) * v_count};
+    Child*       end {first};
+
+    for (int candidate {0}; candidate < v_count; ++candidate) {
+      const int edge_cost {matrix(last, candidate)};
+      if (visited.test(candidate) || edge_cost == -1) {
+        continue;
+      }
 
-  std::stack<WorkingSolution> dfs_stack {
-    {WorkingSolution {.used_vertices =
-                      [&starting_vertex, &v_count]() noexcept {
-                        std::vector root_used_v {std::vector(v_count, false)};
-                        root_used_v.at(starting_vertex) = true;
-                        return root_used_v;
-                      }(),
-                      .solution = {.path = {starting_vertex}, .cost = 0}}}};
-
-  while (!dfs_stack.empty()) [[likely]] {
-    WorkingSolution node {std::move(dfs_stack.top())};
-    dfs_stack.pop();
-
-    const int current_v {node.solution.path.back()};
-    const int current_cost {node.solution.cost};
-
-    // do not explore if already worse or equal
-    if (current_cost >= current_best.cost) [[likely]] {
-      continue;
+      // bound the cheapest tour that could still follow this child
+      const bound::Remainder child_remainder {
+        bound_engine.child(remainder, last, candidate)};
+      const int lower_bound {bound_engine.evaluate(
+      [this, &candidate](int vertex) noexcept {
+        return vertex == candidate || visited.test(vertex);
+      },
+      last,
+      candidate,
+      cost + edge_cost,
+      child_remainder,
+      potentials,
+      current_best.cost)};
+
+      // assigned member by member so the slot keeps its potentials buffer
+      if (lower_bound < current_best.cost) {
+        end->remainder   = child_remainder;
+        end->potentials  = bound_engine.potentials();
+        end->vertex      = candidate;
+        end->edge_cost   = edge_cost;
+        end->lower_bound = lower_bound;
+        ++end;
+      }
     }
 
-    // if leaf add return and compare with best, if no return path ignore
-    if (node.solution.path.size() == v_count) [[unlikely]] {
-      if (const int return_cost {matrix.at(current_v).at(starting_vertex)};
-          return_cost != -1 && current_cost + return_cost < current_best.cost)
-      [[likely]] {
-        current_best       = std::move(node.solution);
-        current_best.cost += return_cost;
-        current_best.path.emplace_back(starting_vertex);
+    // most promising child first so good tours tighten the bound early
+    std::sort(first, end, [](const Child& lhs, const Child& rhs) noexcept {
+      if (lhs.lower_bound != rhs.lower_bound) {
+        return lhs.lower_bound < rhs.lower_bound;
       }
-    } else [[likely]] {
-      // if not leaf add viable children to priority queue
-      for (const auto& child : branch(matrix, node, current_best.cost)) {
-        dfs_stack.emplace(child);
+      return lhs.edge_cost < rhs.edge_cost;
+    });
+
+    for (const Child* child {first}; child != end; ++child) {
+      // sorted, so once one child can not be better none of the rest can
+      if (child->lower_bound >= current_best.cost) {
+        break;
       }
+
+      path[depth] = child->vertex;
+      visited.set(child->vertex);
+      descend(depth + 1,
+              cost + child->edge_cost,
+              child->remainder,
+              child->potentials);
+      visited.reset(child->vertex);
     }
   }
+
+  const tsp::CostMatrix& matrix;
+  tsp::Solution&         current_best;
+  bound::Engine          bound_engine;
+  int                    v_count;
+  std::vector<int>       path;
+  node::Mask<Words>      visited {};
+  std::vector<Child>     children;
+};
+
+template<size_t Words>
+static void algorithm(const tsp::CostMatrix&  matrix,
+                      tsp::Solution&          current_best,
+                      int                     starting_vertex) {
+  Search<Words> {matrix, current_best, starting_vertex}.run();
 }
 
 }    // namespace bxb::dfs::impl
@@ -91,31 +146,33 @@ static void algorithm(const tsp::Matrix<int>& matrix,
 namespace bxb::dfs {
 
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>&   matrix,
+const tsp::CostMatrix&    matrix,
 const tsp::GraphInfo&     graph_info,
-const std::optional<int>& optimal_cost) noexcept {
+const std::optional<int>& optimal_cost,
+const tsp::Construction   initial) noexcept {
   const size_t v_count {matrix.size()};
 
   if (v_count == 1) [[unlikely]] {    //edge case: 1 vertex
     return tsp::Solution {.path = {{0}}, .cost = 0};
   }
 
-  // upper bound = nn solution
-  auto upper_bound_result {nn::run(matrix, graph_info, optimal_cost)};
+  // upper bound = tour of the chosen construction heuristic
+  auto upper_bound_result {
+    util::construct::tour(matrix, graph_info, optimal_cost, initial)};
   if (std::holds_alternative<tsp::ErrorAlgorithm>(upper_bound_result)) {
     return upper_bound_result;
   }
   tsp::Solution best {std::move(std::get<tsp::Solution>(upper_bound_result))};
 
-  if (graph_info.full_graph && graph_info.symmetric_graph) {
-    impl::algorithm(matrix, best, 0);
-  } else {
-    for (int vertex {0}; vertex < v_count; ++vertex) {
-      impl::algorithm(matrix, best, vertex);
-      if (optimal_cost.has_value() && best.cost == *optimal_cost) {
-        break;
-      }
+  // the search is exact and every tour passes through vertex 0, so no other
+  // starting vertex has to be searched
+  if (!optimal_cost.has_value() || best.cost != *optimal_cost) {
+    if (!node::fits(v_count)) [[unlikely]] {
+      return tsp::ErrorAlgorithm::TOO_LARGE;
     }
+    node::dispatch(v_count, [&matrix, &best]<size_t Words>() noexcept {
+      impl::algorithm<Words>(matrix, best, 0);
+    });
   }
 
   if (best.cost == std::numeric_limits<int>::max()) [[unlikely]] {
@@ -1,11 +1,17 @@
 #include "zadanie_2/bxb_lc.hpp"
-#include "zadanie_1/nn.hpp"
+#include "zadanie_2/bxb_bound.hpp"
+#include "zadanie_2/bxb_node.hpp"
+#include "construct.hpp"
+#include "parallel.hpp"
 #include "util.hpp"
 #include <initializer_list>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <limits>
+#include <mutex>
 #include <optional>
 #include <utility>
 #include <variant>
@@ -34,7 +40,7 @@ public:
 
   constexpr T pop() noexcept {
     std::ranges::pop_heap(data, cmp);
-    const T top {std::move(data.back())};
+    T top {std::move(data.back())};
     data.pop_back();
     return top;
   }
@@ -44,81 +50,258 @@ public:
   }
 };
 
-struct WorkingSolution {
-  std::vector<bool> used_vertices;
-  tsp::Solution     solution;
+constexpr static bound::Kind BOUND_KIND {bound::Kind::REDUCTION};
+
+// least lower bound first, deeper first on ties to reach leaves sooner
+template<size_t Words>
+struct LeastBound {
+  constexpr bool operator()(const node::Node<Words>& lhs,
+                            const node::Node<Words>& rhs) const noexcept {
+    if (lhs.lower_bound != rhs.lower_bound) {
+      return lhs.lower_bound > rhs.lower_bound;
+    }
+    return lhs.depth < rhs.depth;
+  }
 };
 
-constexpr static std::vector<WorkingSolution> branch(
-const tsp::Matrix<int>& matrix,
-const WorkingSolution&  node,
-int                     max_cost) noexcept {
+// fills children with the viable children of the node, false once the
+// arena is full
+template<size_t Words>
+[[nodiscard]] static bool branch(
+const tsp::CostMatrix&          matrix,
+bound::Engine&                  bound_engine,
+node::Arena&                    arena,
+const node::Node<Words>&        node,
+int                             max_cost,
+tsp::ThreadStats&               stats,
+std::vector<node::Node<Words>>& children) noexcept {
   const size_t v_count {matrix.size()};
 
-  std::vector<WorkingSolution> children {};
+  children.clear();
 
   for (int candidate {0}; candidate < v_count; ++candidate) {
-    if (const int cost {matrix.at(node.solution.path.back()).at(candidate)};
-        !node.used_vertices.at(candidate) && cost != -1 &&
-        node.solution.cost + cost < max_cost) {
-      children.emplace_back([&candidate, &node, &cost]() noexcept {
-        WorkingSolution next {node};
-        next.solution.path.emplace_back(candidate);
-        next.solution.cost               += cost;
-        next.used_vertices.at(candidate)  = true;
-        return next;
-      }());
+    const int cost {matrix(node.last, candidate)};
+    if (node.visited.test(candidate) || cost == -1) {
+      continue;
+    }
+
+    // bound the cheapest tour that could still follow this child
+    const bound::Remainder remainder {
+      bound_engine.child(node.remainder, node.last, candidate)};
+    const int lower_bound {bound_engine.evaluate(
+    [&node, &candidate](int vertex) noexcept {
+      return vertex == candidate || node.visited.test(vertex);
+    },
+    node.last,
+    candidate,
+    node.cost + cost,
+    remainder,
+    node.potentials,
+    max_cost)};
+
+    if (lower_bound < max_cost) {
+      const node::Link link {arena.append(node.link, candidate)};
+      if (link == node::NO_LINK) [[unlikely]] {
+        return false;
+      }
+
+      node::Node<Words> next {.visited     = node.visited,
+                              .remainder   = remainder,
+                              .potentials  = bound_engine.potentials(),
+                              .link        = link,
+                              .last        = candidate,
+                              .cost        = node.cost + cost,
+                              .lower_bound = lower_bound,
+                              .depth       = node.depth + 1};
+      next.visited.set(candidate);
+      children.emplace_back(std::move(next));
+    } else {
+      ++stats.pruned;
     }
   }
 
-  return children;
+  return true;
 }
 
-constexpr static void algorithm(const tsp::Matrix<int>& matrix,
-                      tsp::Solution&          current_best,
-                      int                     starting_vertex) {
-  const size_t v_count {matrix.size()};
+// heap shared by all workers, a worker waiting on an empty heap counts as
+// idle, the search is over once every worker is idle and the heap is empty
+template<size_t Words>
+class SharedQueue {
+public:
+  explicit SharedQueue(int worker_count) noexcept:
+    worker_count {worker_count} {
+  }
 
-  Heap<WorkingSolution,
-       bool (*)(const WorkingSolution&, const WorkingSolution&) noexcept>
-  least_cost_heap {
-    [](const WorkingSolution& lhs, const WorkingSolution& rhs) noexcept {
-      return lhs.solution.cost > rhs.solution.cost;
-    },
-    {WorkingSolution {.used_vertices =
-                      [&starting_vertex, &v_count]() noexcept {
-                        std::vector root_used_v {std::vector(v_count, false)};
-                        root_used_v.at(starting_vertex) = true;
-                        return root_used_v;
-                      }(),
-                      .solution = {.path = {starting_vertex}, .cost = 0}}}};
-
-  while (!least_cost_heap.empty()) [[likely]] {
-    WorkingSolution node {least_cost_heap.pop()};
-
-    const int current_v {node.solution.path.back()};
-    const int current_cost {node.solution.cost};
-
-    // do not explore if already worse or equal
-    if (current_cost >= current_best.cost) [[likely]] {
-      continue;
+  // nodes are moved into the heap, the vector itself stays reusable
+  void push(std::vector<node::Node<Words>>&& nodes) noexcept {
+    if (nodes.empty()) {
+      return;
     }
 
-    // if leaf add return and compare with best, if no return path ignore
-    if (node.solution.path.size() == v_count) [[unlikely]] {
-      if (const int return_cost {matrix.at(current_v).at(starting_vertex)};
-          return_cost != -1 && current_cost + return_cost < current_best.cost) {
-        current_best       = std::move(node.solution);
-        current_best.cost += return_cost;
-        current_best.path.emplace_back(starting_vertex);
+    {
+      const std::lock_guard lock {mutex};
+      for (auto& node : nodes) {
+        heap.push(std::move(node));
       }
-    } else [[likely]] {
-      // if not leaf add viable children to priority queue
-      for (auto&& child : branch(matrix, node, current_best.cost)) {
-        least_cost_heap.push(std::move(child));
+    }
+
+    if (nodes.size() == 1) {
+      available.notify_one();
+    } else {
+      available.notify_all();
+    }
+  }
+
+  // blocks until a node is available, empty when the search is finished
+  [[nodiscard]] std::optional<node::Node<Words>> pop() noexcept {
+    std::unique_lock lock {mutex};
+
+    ++idle_workers;
+    available.wait(lock, [this]() noexcept {
+      return finished || !heap.empty() || idle_workers == worker_count;
+    });
+
+    if (finished || heap.empty()) {
+      finished = true;
+      lock.unlock();
+      available.notify_all();
+      return std::nullopt;
+    }
+
+    --idle_workers;
+    return heap.pop();
+  }
+
+  void stop() noexcept {
+    {
+      const std::lock_guard lock {mutex};
+      finished = true;
+    }
+    available.notify_all();
+  }
+
+private:
+  Heap<node::Node<Words>, LeastBound<Words>> heap;
+  std::mutex                                 mutex;
+  std::condition_variable                    available;
+  int                                        worker_count;
+  int                                        idle_workers {0};
+  bool                                       finished {false};
+};
+
+// best complete tour, cost is readable without locking for pruning
+struct SharedBest {
+  std::atomic<int> cost {std::numeric_limits<int>::max()};
+  std::mutex       mutex;
+  tsp::Solution    solution;
+
+  // returns true if the offered tour became the new best
+  bool offer(tsp::Solution&& candidate) noexcept {
+    const std::lock_guard lock {mutex};
+    if (candidate.cost >= solution.cost) {
+      return false;
+    }
+    solution = std::move(candidate);
+    cost.store(solution.cost, std::memory_order_relaxed);
+    return true;
+  }
+};
+
+// false if the arena filled up before the search finished
+template<size_t Words>
+[[nodiscard]] static bool algorithm(
+const tsp::CostMatrix&         matrix,
+tsp::Solution&                 current_best,
+int                            starting_vertex,
+const std::optional<int>&      optimal_cost,
+std::vector<tsp::ThreadStats>* stats_out) {
+  const size_t v_count {matrix.size()};
+
+  // every worker blocks in the queue until all of them are idle, so only as
+  // many as really run at once, a nested call runs its tasks one by one
+  util::parallel::ThreadPool& pool {util::parallel::shared_pool()};
+  const int                   worker_count {pool.concurrency()};
+
+  const bound::Engine root_engine {matrix, starting_vertex, BOUND_KIND};
+  node::Arena         arena {};
+  SharedQueue<Words>  queue {worker_count};
+  std::atomic<bool>   arena_full {false};
+
+  SharedBest best {};
+  best.solution = std::move(current_best);
+  best.cost.store(best.solution.cost, std::memory_order_relaxed);
+
+  queue.push({[&]() noexcept {
+    node::Node<Words> root {.visited     = {},
+                            .remainder   = root_engine.root(),
+                            .potentials  = root_engine.root_potentials(),
+                            .link        = arena.append(node::NO_LINK,
+                                                 starting_vertex),
+                            .last        = starting_vertex,
+                            .cost        = 0,
+                            .lower_bound = 0,
+                            .depth       = 1};
+    root.visited.set(starting_vertex);
+    return root;
+  }()});
+
+  std::vector<tsp::ThreadStats> stats(worker_count, tsp::ThreadStats {});
+
+  pool.run(worker_count, [&](int /*worker*/, int task) noexcept {
+    // the engine keeps scratch buffers, every worker needs its own copy
+    bound::Engine                  bound_engine {root_engine};
+    tsp::ThreadStats&              thread_stats {stats.at(task)};
+    std::vector<node::Node<Words>> children {};
+
+    while (const auto popped {queue.pop()}) [[likely]] {
+      const node::Node<Words>& node {*popped};
+      const int best_cost {best.cost.load(std::memory_order_relaxed)};
+
+      // do not explore if can not be better
+      if (node.lower_bound >= best_cost) [[likely]] {
+        ++thread_stats.pruned;
+        continue;
+      }
+
+      // if leaf add return and compare with best, if no return path ignore
+      if (node.depth == v_count) [[unlikely]] {
+        ++thread_stats.leaves;
+        if (const int return_cost {matrix(node.last, starting_vertex)};
+            return_cost != -1 && node.cost + return_cost < best_cost) {
+          tsp::Solution leaf {.path = arena.path(node.link, node.depth),
+                              .cost = node.cost + return_cost};
+          leaf.path.emplace_back(starting_vertex);
+          if (best.offer(std::move(leaf)) && optimal_cost.has_value() &&
+              best.cost.load(std::memory_order_relaxed) <= *optimal_cost)
+          [[unlikely]] {
+            queue.stop();
+          }
+        }
+      } else [[likely]] {
+        // if not leaf add viable children to the shared queue
+        ++thread_stats.expanded;
+        if (!branch(matrix,
+                    bound_engine,
+                    arena,
+                    node,
+                    best_cost,
+                    thread_stats,
+                    children)) [[unlikely]] {
+          arena_full.store(true, std::memory_order_relaxed);
+          queue.stop();
+          continue;
+        }
+        queue.push(std::move(children));
       }
     }
+  });
+
+  current_best = std::move(best.solution);
+  if (stats_out != nullptr) {
+    *stats_out = std::move(stats);
   }
+
+  return !arena_full.load(std::memory_order_relaxed);
 }
 
 }    // namespace bxb::lc::impl
@@ -126,30 +309,38 @@ constexpr static void algorithm(const tsp::Matrix<int>& matrix,
 namespace bxb::lc {
 
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>&   matrix,
-const tsp::GraphInfo&     graph_info,
-const std::optional<int>& optimal_cost) noexcept {
+const tsp::CostMatrix&               matrix,
+const tsp::GraphInfo&                graph_info,
+const std::optional<int>&            optimal_cost,
+const tsp::Construction              initial,
+std::vector<tsp::ThreadStats>* const thread_stats) noexcept {
   const size_t v_count {matrix.size()};
 
   if (v_count == 1) [[unlikely]] {    //edge case: 1 vertex
     return tsp::Solution {.path = {{0}}, .cost = 0};
   }
 
-  // upper bound = nn solution
-  auto upper_bound_result {nn::run(matrix, graph_info, optimal_cost)};
+  // upper bound = tour of the chosen construction heuristic
+  auto upper_bound_result {
+    util::construct::tour(matrix, graph_info, optimal_cost, initial)};
   if (std::holds_alternative<tsp::ErrorAlgorithm>(upper_bound_result)) {
     return upper_bound_result;
   }
   tsp::Solution best {std::move(std::get<tsp::Solution>(upper_bound_result))};
 
-  if (graph_info.full_graph && graph_info.symmetric_graph) {
-    impl::algorithm(matrix, best, 0);
-  } else {
-    for (int vertex {0}; vertex < v_count; ++vertex) {
-      impl::algorithm(matrix, best, vertex);
-      if (optimal_cost.has_value() && best.cost == *optimal_cost) {
-        break;
-      }
+  // the search is exact and every tour passes through vertex 0, so no other
+  // starting vertex has to be searched
+  if (!optimal_cost.has_value() || best.cost != *optimal_cost) {
+    if (!node::fits(v_count)) [[unlikely]] {
+      return tsp::ErrorAlgorithm::TOO_LARGE;
+    }
+    bool finished {true};
+    node::dispatch(v_count, [&]<size_t Words>() noexcept {
+      finished =
+      impl::algorithm<Words>(matrix, best, 0, optimal_cost, thread_stats);
+    });
+    if (!finished) [[unlikely]] {
+      return tsp::ErrorAlgorithm::TOO_LARGE;
     }
   }
 
@@ -0,0 +1,53 @@
+#include "zadanie_2/bxb_node.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace bxb::node {
+
+Arena::Arena() noexcept:
+  chunks {std::make_unique<std::atomic<Step*>[]>(CHUNK_COUNT)} {
+}
+
+Link Arena::append(Link parent, int vertex) noexcept {
+  const uint64_t index {next.fetch_add(1, std::memory_order_relaxed)};
+  if (index >= NO_LINK) [[unlikely]] {
+    return NO_LINK;
+  }
+
+  const Link   link {static_cast<Link>(index)};
+  const size_t chunk {link >> CHUNK_BITS};
+
+  Step* steps {chunks[chunk].load(std::memory_order_acquire)};
+  if (steps == nullptr) [[unlikely]] {
+    // first step of a chunk, whoever gets the lock first allocates it
+    const std::lock_guard lock {grow_mutex};
+    steps = chunks[chunk].load(std::memory_order_relaxed);
+    if (steps == nullptr) {
+      steps = owned.emplace_back(std::make_unique<Step[]>(CHUNK_SIZE)).get();
+      chunks[chunk].store(steps, std::memory_order_release);
+    }
+  }
+
+  steps[link & (CHUNK_SIZE - 1)] = {.parent = parent, .vertex = vertex};
+  return link;
+}
+
+std::vector<int> Arena::path(Link last, int depth) const noexcept {
+  std::vector<int> result(depth);
+
+  for (int i {depth - 1}; i >= 0 && last != NO_LINK; --i) {
+    const Step& step {chunks[last >> CHUNK_BITS].load(
+    std::memory_order_acquire)[last & (CHUNK_SIZE - 1)]};
+    result.at(i) = step.vertex;
+    last         = step.parent;
+  }
+
+  return result;
+}
+
+}    // namespace bxb::node
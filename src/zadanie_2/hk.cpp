@@ -0,0 +1,201 @@
+#include "zadanie_2/hk.hpp"
+
+#include "util.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <variant>
+#include <vector>
+
+namespace hk::impl {
+
+using Mask = uint32_t;
+
+constexpr static int INF {std::numeric_limits<int>::max()};
+
+// upper limit on the size of the dp table, n = 25 takes ~1.6 GiB
+constexpr static size_t MAX_TABLE_BYTES {size_t {2} << 30};
+
+// vertex 0 is the fixed start, vertex v + 1 is represented by bit v of the mask
+// and by column v of a dp row, so one row holds all the paths over one subset
+struct Table {
+  std::vector<int> cells;
+  int              width;
+
+  [[nodiscard]] constexpr int* row(Mask mask) noexcept {
+    return cells.data() + static_cast<size_t>(mask) * width;
+  }
+
+  [[nodiscard]] constexpr const int* row(Mask mask) const noexcept {
+    return cells.data() + static_cast<size_t>(mask) * width;
+  }
+};
+
+[[nodiscard]] constexpr static bool fits_in_budget(size_t v_count) noexcept {
+  const size_t width {v_count - 1};
+
+  if (width >= std::numeric_limits<Mask>::digits) [[unlikely]] {
+    return false;
+  }
+
+  return (size_t {1} << width) * width * sizeof(int) <= MAX_TABLE_BYTES;
+}
+
+// cost of edge (from + 1) -> (to + 1) stored as incoming[to][from], so the
+// inner loop over predecessors reads a contiguous row
+[[nodiscard]] static std::vector<int> incoming_costs(
+const tsp::CostMatrix& matrix) noexcept {
+  const int width {static_cast<int>(matrix.size()) - 1};
+
+  std::vector<int> incoming(static_cast<size_t>(width) * width, -1);
+  for (int to {0}; to < width; ++to) {
+    for (int from {0}; from < width; ++from) {
+      incoming[static_cast<size_t>(to) * width + from] = matrix(from + 1, to + 1);
+    }
+  }
+
+  return incoming;
+}
+
+// time O(2^n * n^2), memory O(2^n * n)
+static void fill(const tsp::CostMatrix& matrix, Table& table) noexcept {
+  const int  width {table.width};
+  const Mask full {(Mask {1} << width) - 1};
+
+  const std::vector<int> incoming {incoming_costs(matrix)};
+
+  // paths of a single edge from the start
+  for (int v {0}; v < width; ++v) {
+    const int cost {matrix(0, v + 1)};
+    table.row(Mask {1} << v)[v] = cost == -1 ? INF : cost;
+  }
+
+  // every subset is processed after all of its subsets (they are smaller)
+  for (Mask mask {1}; mask <= full; ++mask) {
+    if (std::has_single_bit(mask)) {
+      continue;
+    }
+
+    int* const row {table.row(mask)};
+
+    for (Mask to_bits {mask}; to_bits != 0; to_bits &= to_bits - 1) {
+      const int  to {std::countr_zero(to_bits)};
+      const Mask prev_mask {mask ^ (Mask {1} << to)};
+
+      const int* const prev_row {table.row(prev_mask)};
+      const int* const to_costs {incoming.data() +
+                                 static_cast<size_t>(to) * width};
+
+      int best {INF};
+      for (Mask from_bits {prev_mask}; from_bits != 0;
+           from_bits &= from_bits - 1) {
+        const int from {std::countr_zero(from_bits)};
+
+        const int prev_cost {prev_row[from]};
+        const int edge_cost {to_costs[from]};
+
+        if (prev_cost != INF && edge_cost != -1 &&
+            prev_cost + edge_cost < best) {
+          best = prev_cost + edge_cost;
+        }
+      }
+
+      row[to] = best;
+    }
+  }
+}
+
+// walk the table back from the cheapest closed tour
+[[nodiscard]] static std::optional<tsp::Solution> reconstruct(
+const tsp::CostMatrix& matrix,
+const Table&           table) noexcept {
+  const int  width {table.width};
+  const Mask full {(Mask {1} << width) - 1};
+
+  int best_cost {INF};
+  int last {-1};
+  for (int v {0}; v < width; ++v) {
+    const int path_cost {table.row(full)[v]};
+    const int return_cost {matrix(v + 1, 0)};
+
+    if (path_cost != INF && return_cost != -1 &&
+        path_cost + return_cost < best_cost) {
+      best_cost = path_cost + return_cost;
+      last      = v;
+    }
+  }
+
+  if (last == -1) [[unlikely]] {
+    return std::nullopt;
+  }
+
+  std::vector path(static_cast<size_t>(width) + 2, 0);
+
+  Mask mask {full};
+  int  current {last};
+  for (int position {width}; position > 0; --position) {
+    path.at(position) = current + 1;
+
+    const Mask prev_mask {mask ^ (Mask {1} << current)};
+    const int  current_cost {table.row(mask)[current]};
+
+    int prev {-1};
+    for (Mask from_bits {prev_mask}; from_bits != 0;
+         from_bits &= from_bits - 1) {
+      const int from {std::countr_zero(from_bits)};
+
+      const int prev_cost {table.row(prev_mask)[from]};
+      const int edge_cost {matrix(from + 1, current + 1)};
+
+      if (prev_cost != INF && edge_cost != -1 &&
+          prev_cost + edge_cost == current_cost) {
+        prev = from;
+        break;
+      }
+    }
+
+    mask    = prev_mask;
+    current = prev;
+  }
+
+  return tsp::Solution {.path = std::move(path), .cost = best_cost};
+}
+
+}    // namespace hk::impl
+
+namespace hk {
+
+[[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
+const tsp::CostMatrix& matrix,
+const tsp::GraphInfo&,
+const std::optional<int>&) noexcept {
+  const size_t v_count {matrix.size()};
+
+  if (v_count == 1) [[unlikely]] {    //edge case: 1 vertex
+    return tsp::Solution {.path = {{0}}, .cost = 0};
+  }
+
+  if (!impl::fits_in_budget(v_count)) [[unlikely]] {
+    return tsp::ErrorAlgorithm::TOO_LARGE;
+  }
+
+  const int width {static_cast<int>(v_count) - 1};
+
+  impl::Table table {
+    .cells = std::vector((size_t {1} << width) * width, impl::INF),
+    .width = width};
+
+  impl::fill(matrix, table);
+
+  std::optional best {impl::reconstruct(matrix, table)};
+  if (!best.has_value()) [[unlikely]] {
+    return tsp::ErrorAlgorithm::NO_PATH;
+  }
+
+  return std::move(*best);
+}
+
+}    // namespace hk
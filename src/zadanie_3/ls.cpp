@@ -0,0 +1,51 @@
+#include "zadanie_3/ls.hpp"
+
+#include "anytime.hpp"
+#include "construct.hpp"
+#include "local_search.hpp"
+#include "neighbours.hpp"
+#include "util.hpp"
+
+#include <optional>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace ls {
+
+[[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
+const tsp::CostMatrix&    matrix,
+const tsp::GraphInfo&     graph_info,
+const std::optional<int>& optimal_cost,
+const tsp::LocalSearch    method,
+const int                 candidate_count,
+const tsp::Construction   initial) noexcept {
+  if (method == tsp::LocalSearch::NONE || candidate_count < 1) [[unlikely]] {
+    return tsp::ErrorAlgorithm::INVALID_PARAM;
+  }
+
+  if (matrix.size() == 1) [[unlikely]] {    //edge case: 1 vertex
+    return tsp::Solution {.path = {{0}}, .cost = 0};
+  }
+
+  auto start {
+    util::construct::tour(matrix, graph_info, optimal_cost, initial)};
+  if (std::holds_alternative<tsp::ErrorAlgorithm>(start)) [[unlikely]] {
+    return start;
+  }
+  tsp::Solution tour {std::move(std::get<tsp::Solution>(start))};
+  util::anytime::record(tour.cost);
+
+  const util::neighbours::Lists candidates {matrix, candidate_count};
+  util::local_search::Engine    engine {
+    matrix, candidates, graph_info.symmetric_graph};
+
+  // to the local optimum, every vertex is looked at until no move improves
+  if (engine.improve(method, tour, 0) != 0) {
+    util::anytime::record(tour.cost);
+  }
+
+  return tour;
+}
+
+}    // namespace ls
@@ -1,14 +1,24 @@
 #include "zadanie_3/ts.hpp"
+#include "zadanie_3/ts_kernel.hpp"
 
-#include "zadanie_1/nn.hpp"
+#include "anytime.hpp"
+#include "construct.hpp"
+#include "local_search.hpp"
+#include "neighbours.hpp"
+#include "parallel.hpp"
+#include "rng.hpp"
 #include "util.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include <variant>
 #include <optional>
 #include <utility>
 #include <limits>
 #include <cstddef>
+#include <tuple>
 
 namespace ts::impl {
 
@@ -17,60 +27,110 @@ struct WorkingSolution {
   tsp::Solution       solution;
 };
 
-struct SwapCandidate {
-  int  first_v;
-  int  second_v;
+// move in the current neighbourhood, first and second are path indices:
+// swap     -> vertices at first and second are exchanged
+// 2opt     -> segment (first, second] is reversed
+// or-opt   -> segment [first, first + length) is moved behind second
+struct Candidate {
+  int  first;
+  int  second;
+  int  length;
   int  delta_cost;
   bool tabu;
   bool aspiration_criterion;
 };
 
+// prefix sums of edge costs along the path in both directions, lets the
+// cost of a reversed segment be read in O(1) on asymmetric instances, on
+// symmetric ones a reversed segment costs the same and it is not built
+struct PathPrefix {
+  std::vector<int> forward;     // cost of path[0] -> ... -> path[k]
+  std::vector<int> backward;    // cost of path[k] -> ... -> path[0]
+  std::vector<int> missing;     // count of missing reversed edges up to k
+};
+
+constexpr static int OR_OPT_MAX_LENGTH {3};
+
+// neighbour list length of the local search polishing the best tour, the
+// tabu lists may be off (candidates = 0)
+constexpr static int LOCAL_SEARCH_NEIGHBOURS {10};
+
+static WorkingSolution to_working(tsp::Solution solution,
+                                  size_t        v_count) noexcept {
+  std::vector indices {std::vector(v_count, std::numeric_limits<size_t>::max())};
+  for (size_t v {0}; v < solution.path.size() - 1; ++v) {
+    indices.at(solution.path.at(v)) = v;
+  }
+
+  return WorkingSolution {.v_indices = std::move(indices),
+                          .solution  = std::move(solution)};
+}
+
 static std::variant<WorkingSolution, tsp::ErrorAlgorithm> get_first_solution(
-const tsp::Matrix<int>& matrix,
+const tsp::CostMatrix&  matrix,
 const tsp::GraphInfo&   graph_info,
-std::optional<int>      optimal_cost) noexcept {
+std::optional<int>      optimal_cost,
+tsp::Construction       initial) noexcept {
   const size_t v_count {matrix.size()};
 
-  // use nn
-  const auto upper_bound_result {nn::run(matrix, graph_info, optimal_cost)};
+  // use the chosen construction heuristic
+  const auto upper_bound_result {
+    util::construct::tour(matrix, graph_info, optimal_cost, initial)};
   if (std::holds_alternative<tsp::ErrorAlgorithm>(upper_bound_result)) {
     return std::get<tsp::ErrorAlgorithm>(upper_bound_result);
   }
-  tsp::Solution upper_bound {std::get<tsp::Solution>(upper_bound_result)};
-  std::vector   indices {
-    std::vector(v_count, std::numeric_limits<size_t>::max())};
-  for (size_t v {0}; v < upper_bound.path.size() - 1; ++v) {
-    indices.at(upper_bound.path.at(v)) = v;
-  }
 
-  return WorkingSolution {.v_indices = std::move(indices),
-                          .solution  = std::move(upper_bound)};
+  return to_working(std::get<tsp::Solution>(upper_bound_result), v_count);
 }
 
-constexpr static void mark_tabu(tsp::Matrix<int>& tabu_matrix,
-                                int               first_v,
-                                int               second_v,
-                                int               count_of_tabu_itr) noexcept {
-  tabu_matrix.at(first_v).at(second_v) = count_of_tabu_itr;
-  tabu_matrix.at(second_v).at(first_v) = count_of_tabu_itr;
-}
+// iteration at which each vertex pair leaves tabu, a move is tabu in both
+// directions so pairs are unordered and kept in a triangular array, O(1)
+// mark and check with no per iteration sweep
+class TabuList {
+public:
+  explicit TabuList(size_t v_count) noexcept:
+    expiry(v_count * (v_count - 1) / 2, 0) {
+  }
 
-constexpr static bool is_tabu(const tsp::Matrix<int>& tabu_matrix,
-                              int                     first_v,
-                              int                     second_v) noexcept {
-  return tabu_matrix.at(first_v).at(second_v) > 0 ||
-         tabu_matrix.at(second_v).at(first_v) > 0;
-}
+  constexpr void mark(int first_v, int second_v, int tabu_itr_count) noexcept {
+    expiry[index(first_v, second_v)] = itr + tabu_itr_count;
+  }
 
-constexpr static void update_tabu(tsp::Matrix<int>& tabu_matrix) noexcept {
-  for (auto& each : tabu_matrix) {
-    for (auto& value : each) {
-      --value;
-    }
+  [[nodiscard]] constexpr bool is_tabu(int first_v,
+                                       int second_v) const noexcept {
+    return expiry[index(first_v, second_v)] > itr;
   }
-}
 
-constexpr static int get_delta_cost(const tsp::Matrix<int>& matrix,
+  constexpr void next_itr() noexcept {
+    ++itr;
+  }
+
+  // forgets every mark, O(n^2)
+  void clear() noexcept {
+    std::ranges::fill(expiry, 0);
+    itr = 0;
+  }
+
+  [[nodiscard]] constexpr const int* data() const noexcept {
+    return expiry.data();
+  }
+
+  [[nodiscard]] constexpr int current_itr() const noexcept {
+    return itr;
+  }
+
+private:
+  [[nodiscard]] constexpr static size_t index(int first_v,
+                                              int second_v) noexcept {
+    const auto [low, high] {std::minmax(first_v, second_v)};
+    return static_cast<size_t>(high) * (high - 1) / 2 + low;
+  }
+
+  std::vector<int> expiry;
+  int              itr {0};
+};
+
+constexpr static int get_delta_cost(const tsp::CostMatrix&  matrix,
                                     const WorkingSolution&  current_solution,
                                     int                     first_v,
                                     int                     second_v) noexcept {
@@ -87,22 +147,22 @@ constexpr static int get_delta_cost(const tsp::Matrix<int>& matrix,
   const int second_prev {current_solution.solution.path.at(second_v_idx - 1)};
   const int second_next {current_solution.solution.path.at(second_v_idx + 1)};
 
-  const int first_prev_old_cost {matrix.at(first_prev).at(first_v)};
-  const int first_next_old_cost {matrix.at(first_v).at(first_next)};
-  const int second_prev_old_cost {matrix.at(second_prev).at(second_v)};
-  const int second_next_old_cost {matrix.at(second_v).at(second_next)};
+  const int first_prev_old_cost {matrix(first_prev, first_v)};
+  const int first_next_old_cost {matrix(first_v, first_next)};
+  const int second_prev_old_cost {matrix(second_prev, second_v)};
+  const int second_next_old_cost {matrix(second_v, second_next)};
 
   const int first_prev_new_cost {first_prev != second_v
-                                 ? matrix.at(first_prev).at(second_v)
-                                 : matrix.at(first_v).at(second_v)};
+                                 ? matrix(first_prev, second_v)
+                                 : matrix(first_v, second_v)};
   const int first_next_new_cost {second_v != first_next
-                                 ? matrix.at(second_v).at(first_next)
+                                 ? matrix(second_v, first_next)
                                  : first_next_old_cost};
   const int second_prev_new_cost {second_prev != first_v
-                                  ? matrix.at(second_prev).at(first_v)
-                                  : matrix.at(second_v).at(first_v)};
+                                  ? matrix(second_prev, first_v)
+                                  : matrix(second_v, first_v)};
   const int second_next_new_cost {first_v != second_next
-                                  ? matrix.at(first_v).at(second_next)
+                                  ? matrix(first_v, second_next)
                                   : second_next_old_cost};
 
   if (first_prev_new_cost == -1 || first_next_new_cost == -1 ||
@@ -119,99 +179,756 @@ constexpr static int get_delta_cost(const tsp::Matrix<int>& matrix,
   return new_cost - old_cost;
 }
 
-constexpr static SwapCandidate get_best_candidate(
-const tsp::Matrix<int>& matrix,
-const tsp::Matrix<int>& tabu_matrix,
-const WorkingSolution&  solution,
-int                     current_best_cost) noexcept {
-  const size_t path_size {solution.solution.path.size()};
-
-  SwapCandidate best_candidate {.first_v    = 0,
-                                .second_v   = 1,
-                                .delta_cost = std::numeric_limits<int>::max(),
-                                .tabu       = false,
-                                .aspiration_criterion = false};
-
-  for (int first_v_idx {0}; first_v_idx < path_size - 2; ++first_v_idx) {
-    for (int second_v_idx {first_v_idx + 1}; second_v_idx < path_size - 1;
-         ++second_v_idx) {
-      const int first_v {solution.solution.path.at(first_v_idx)};
-      const int second_v {solution.solution.path.at(second_v_idx)};
-
-      const int delta_cost {
-        get_delta_cost(matrix, solution, first_v, second_v)};
-
-      // if would break solution, skip
-      if (delta_cost == std::numeric_limits<int>::max()) [[unlikely]] {
+// lower delta wins, ties go to the lexicographically smallest move so the
+// result does not depend on scan order or on how the scan was split
+constexpr static bool is_better(const Candidate& lhs,
+                                const Candidate& rhs) noexcept {
+  if (lhs.delta_cost != rhs.delta_cost) {
+    return lhs.delta_cost < rhs.delta_cost;
+  }
+  return std::tie(lhs.first, lhs.second, lhs.length) <
+         std::tie(rhs.first, rhs.second, rhs.length);
+}
+
+// part of the scan done by one thread, outer loop indices
+// offset, offset + stride, ...
+struct Slice {
+  int offset;
+  int stride;
+};
+
+// keeps the candidate if it is allowed and better than the best one so far
+constexpr static void consider(Candidate&             best_candidate,
+                               const TabuList&        tabu_list,
+                               const WorkingSolution& solution,
+                               int                    current_best_cost,
+                               int                    first,
+                               int                    second,
+                               int                    length,
+                               int                    delta_cost) noexcept {
+  const bool tabu {tabu_list.is_tabu(solution.solution.path.at(first),
+                                     solution.solution.path.at(second))};
+  const bool aspiration_criterion {solution.solution.cost + delta_cost <
+                                   current_best_cost};
+
+  const Candidate candidate {.first                = first,
+                             .second               = second,
+                             .length               = length,
+                             .delta_cost           = delta_cost,
+                             .tabu                 = tabu,
+                             .aspiration_criterion = aspiration_criterion};
+
+  if ((!tabu || aspiration_criterion) && is_better(candidate, best_candidate)) {
+    best_candidate = candidate;
+  }
+}
+
+constexpr static void consider_swap(const tsp::CostMatrix&  matrix,
+                                    const TabuList&         tabu_list,
+                                    const WorkingSolution&  solution,
+                                    int                     current_best_cost,
+                                    int                     first_v_idx,
+                                    int                     second_v_idx,
+                                    Candidate& best_candidate) noexcept {
+  const int delta_cost {get_delta_cost(matrix,
+                                       solution,
+                                       solution.solution.path.at(first_v_idx),
+                                       solution.solution.path.at(second_v_idx))};
+
+  // if would break solution, skip
+  if (delta_cost == std::numeric_limits<int>::max()) [[unlikely]] {
+    return;
+  }
+
+  consider(best_candidate,
+           tabu_list,
+           solution,
+           current_best_cost,
+           first_v_idx,
+           second_v_idx,
+           1,
+           delta_cost);
+}
+
+// with candidate lists only pairs where the second vertex is one of the
+// nearest of the first are tried
+constexpr static void scan_swap(const tsp::CostMatrix&         matrix,
+                                const TabuList&                tabu_list,
+                                const WorkingSolution&         solution,
+                                const util::neighbours::Lists& candidates,
+                                int current_best_cost,
+                                Slice slice,
+                                Candidate& best_candidate) noexcept {
+  const int path_size {static_cast<int>(solution.solution.path.size())};
+
+  if (!candidates.empty()) {
+    for (int first_v_idx {slice.offset}; first_v_idx < path_size - 1;
+         first_v_idx += slice.stride) {
+      for (const int second_v :
+           candidates.of(solution.solution.path[first_v_idx])) {
+        const int second_v_idx {
+          static_cast<int>(solution.v_indices[second_v])};
+        consider_swap(matrix,
+                      tabu_list,
+                      solution,
+                      current_best_cost,
+                      std::min(first_v_idx, second_v_idx),
+                      std::max(first_v_idx, second_v_idx),
+                      best_candidate);
+      }
+    }
+    return;
+  }
+
+  const int v_count {path_size - 1};
+
+  for (int first_v_idx {slice.offset}; first_v_idx < path_size - 2;
+       first_v_idx += slice.stride) {
+    // adjacent and wrap around pairs share an edge, the general formula of
+    // the kernel does not cover them
+    consider_swap(matrix,
+                  tabu_list,
+                  solution,
+                  current_best_cost,
+                  first_v_idx,
+                  first_v_idx + 1,
+                  best_candidate);
+    if (first_v_idx == 0 && v_count > 2) {
+      consider_swap(matrix,
+                    tabu_list,
+                    solution,
+                    current_best_cost,
+                    0,
+                    v_count - 1,
+                    best_candidate);
+    }
+
+    const kernel::RowBest row_best {kernel::swap_row(
+    {.costs            = matrix.data(),
+     .stride           = matrix.stride(),
+     .path             = solution.solution.path.data(),
+     .tabu_expiry      = tabu_list.data(),
+     .itr              = tabu_list.current_itr(),
+     .v_count          = v_count,
+     .first            = first_v_idx,
+     .from             = first_v_idx + 2,
+     .to               = first_v_idx == 0 ? v_count - 1 : v_count,
+     .aspiration_delta = current_best_cost - solution.solution.cost})};
+
+    if (row_best.delta_cost != std::numeric_limits<int>::max()) {
+      consider(best_candidate,
+               tabu_list,
+               solution,
+               current_best_cost,
+               first_v_idx,
+               row_best.second,
+               1,
+               row_best.delta_cost);
+    }
+  }
+}
+
+// entries before from stay valid, a move that leaves path[0 .. from - 1] in
+// place only has to rebuild the rest
+static void build_prefix(const tsp::CostMatrix& matrix,
+                         const WorkingSolution& solution,
+                         size_t                 from,
+                         PathPrefix&            prefix) noexcept {
+  const std::vector<int>& path {solution.solution.path};
+
+  if (from == 0) {
+    prefix.forward.resize(path.size());
+    prefix.backward.resize(path.size());
+    prefix.missing.resize(path.size());
+    prefix.forward.at(0)  = 0;
+    prefix.backward.at(0) = 0;
+    prefix.missing.at(0)  = 0;
+    from                  = 1;
+  }
+
+  for (size_t i {from}; i < path.size(); ++i) {
+    const int reversed {matrix(path.at(i), path.at(i - 1))};
+    prefix.forward.at(i) =
+    prefix.forward.at(i - 1) + matrix(path.at(i - 1), path.at(i));
+    prefix.backward.at(i) =
+    prefix.backward.at(i - 1) + (reversed == -1 ? 0 : reversed);
+    prefix.missing.at(i) = prefix.missing.at(i - 1) + (reversed == -1 ? 1 : 0);
+  }
+}
+
+// reversing (first, second] replaces edges first -> first + 1 and
+// second -> second + 1 and flips every edge inside the segment
+constexpr static void consider_two_opt(const tsp::CostMatrix&  matrix,
+                                       const TabuList&         tabu_list,
+                                       const WorkingSolution&  solution,
+                                       const PathPrefix&       prefix,
+                                       bool                    symmetric,
+                                       int current_best_cost,
+                                       int first,
+                                       int second,
+                                       Candidate& best_candidate) noexcept {
+  const std::vector<int>& path {solution.solution.path};
+  const int               v_count {static_cast<int>(path.size()) - 1};
+
+  // reversing everything but path[0] only turns a symmetric tour around,
+  // on asymmetric instances it is a move like any other
+  if (second - first < 2 ||
+      (symmetric && first == 0 && second == v_count - 1)) {
+    return;
+  }
+
+  const int a {path[first]};
+  const int b {path[first + 1]};
+  const int c {path[second]};
+  const int d {path[second + 1]};
+
+  const int new_first_edge {matrix(a, c)};
+  const int new_second_edge {matrix(b, d)};
+  if (new_first_edge == -1 || new_second_edge == -1) [[unlikely]] {
+    return;
+  }
+
+  int segment_delta {0};
+  if (!symmetric) {
+    if (prefix.missing[second] != prefix.missing[first + 1]) [[unlikely]] {
+      return;
+    }
+    segment_delta = (prefix.backward[second] - prefix.backward[first + 1]) -
+                    (prefix.forward[second] - prefix.forward[first + 1]);
+  }
+
+  consider(best_candidate,
+           tabu_list,
+           solution,
+           current_best_cost,
+           first,
+           second,
+           second - first,
+           new_first_edge + new_second_edge + segment_delta - matrix(a, b) -
+           matrix(c, d));
+}
+
+// with candidate lists the new edge path[first] -> path[second] has to join
+// a vertex with one of its nearest, on symmetric instances in any direction
+constexpr static void scan_two_opt(const tsp::CostMatrix&         matrix,
+                                   const TabuList&                tabu_list,
+                                   const WorkingSolution&         solution,
+                                   const PathPrefix&              prefix,
+                                   const util::neighbours::Lists& candidates,
+                                   bool                           symmetric,
+                                   int current_best_cost,
+                                   Slice slice,
+                                   Candidate& best_candidate) noexcept {
+  const std::vector<int>& path {solution.solution.path};
+  const int               v_count {static_cast<int>(path.size()) - 1};
+
+  if (!candidates.empty()) {
+    for (int first {slice.offset}; first < v_count; first += slice.stride) {
+      for (const int vertex : candidates.of(path[first])) {
+        const int second {static_cast<int>(solution.v_indices[vertex])};
+        if (second < first && !symmetric) {
+          continue;
+        }
+        consider_two_opt(matrix,
+                         tabu_list,
+                         solution,
+                         prefix,
+                         symmetric,
+                         current_best_cost,
+                         std::min(first, second),
+                         std::max(first, second),
+                         best_candidate);
+      }
+    }
+    return;
+  }
+
+  for (int first {slice.offset}; first < v_count - 2;
+       first += slice.stride) {
+    for (int second {first + 2}; second < v_count; ++second) {
+      consider_two_opt(matrix,
+                       tabu_list,
+                       solution,
+                       prefix,
+                       symmetric,
+                       current_best_cost,
+                       first,
+                       second,
+                       best_candidate);
+    }
+  }
+}
+
+// segment [first, first + length) never contains path[0], it is cut out and
+// put between path[second] and path[second + 1] keeping its direction,
+// removed is the cost change of closing the gap it leaves
+constexpr static void consider_or_opt(const tsp::CostMatrix&  matrix,
+                                      const TabuList&         tabu_list,
+                                      const WorkingSolution&  solution,
+                                      int  current_best_cost,
+                                      int  first,
+                                      int  length,
+                                      int  second,
+                                      int  removed,
+                                      Candidate& best_candidate) noexcept {
+  const std::vector<int>& path {solution.solution.path};
+  const int               last {first + length - 1};
+
+  if (second >= first - 1 && second <= last) {
+    return;
+  }
+
+  const int entry_edge {matrix(path[second], path[first])};
+  const int exit_edge {matrix(path[last], path[second + 1])};
+  if (entry_edge == -1 || exit_edge == -1) [[unlikely]] {
+    return;
+  }
+
+  consider(best_candidate,
+           tabu_list,
+           solution,
+           current_best_cost,
+           first,
+           second,
+           length,
+           removed + entry_edge + exit_edge -
+           matrix(path[second], path[second + 1]));
+}
+
+// with candidate lists the segment is only put in front of one of the
+// nearest successors of its last vertex
+constexpr static void scan_or_opt(const tsp::CostMatrix&         matrix,
+                                  const TabuList&                tabu_list,
+                                  const WorkingSolution&         solution,
+                                  const util::neighbours::Lists& candidates,
+                                  int current_best_cost,
+                                  Slice slice,
+                                  Candidate& best_candidate) noexcept {
+  const std::vector<int>& path {solution.solution.path};
+  const int               v_count {static_cast<int>(path.size()) - 1};
+
+  for (int length {1}; length <= OR_OPT_MAX_LENGTH && length < v_count - 1;
+       ++length) {
+    for (int first {1 + slice.offset}; first + length <= v_count;
+         first += slice.stride) {
+      const int last {first + length - 1};
+      const int prev {path[first - 1]};
+      const int next {path[last + 1]};
+
+      const int closing_edge {matrix(prev, next)};
+      if (closing_edge == -1) [[unlikely]] {
+        continue;
+      }
+
+      const int removed {closing_edge - matrix(prev, path[first]) -
+                         matrix(path[last], next)};
+
+      if (!candidates.empty()) {
+        for (const int vertex : candidates.of(path[last])) {
+          const int idx {static_cast<int>(solution.v_indices[vertex])};
+          consider_or_opt(matrix,
+                          tabu_list,
+                          solution,
+                          current_best_cost,
+                          first,
+                          length,
+                          idx == 0 ? v_count - 1 : idx - 1,
+                          removed,
+                          best_candidate);
+        }
         continue;
       }
 
-      const bool tabu {is_tabu(tabu_matrix, first_v, second_v)};
-      const bool aspiration_criterion {solution.solution.cost + delta_cost <
-                                       current_best_cost};
-
-      if ((!tabu || aspiration_criterion) &&
-          delta_cost < best_candidate.delta_cost) {
-        best_candidate =
-        SwapCandidate {.first_v              = first_v,
-                       .second_v             = second_v,
-                       .delta_cost           = delta_cost,
-                       .tabu                 = tabu,
-                       .aspiration_criterion = aspiration_criterion};
+      for (int second {0}; second < v_count; ++second) {
+        consider_or_opt(matrix,
+                        tabu_list,
+                        solution,
+                        current_best_cost,
+                        first,
+                        length,
+                        second,
+                        removed,
+                        best_candidate);
       }
     }
   }
+}
+
+constexpr static Candidate NO_CANDIDATE {
+  .first                = 0,
+  .second               = 1,
+  .length               = 1,
+  .delta_cost           = std::numeric_limits<int>::max(),
+  .tabu                 = false,
+  .aspiration_criterion = false};
+
+static Candidate scan_slice(const tsp::CostMatrix&         matrix,
+                            const TabuList&                tabu_list,
+                            const WorkingSolution&         solution,
+                            const PathPrefix&              prefix,
+                            const util::neighbours::Lists& candidates,
+                            tsp::Neighbourhood             neighbourhood,
+                            bool                           symmetric,
+                            int                            current_best_cost,
+                            Slice                          slice) noexcept {
+  Candidate best_candidate {NO_CANDIDATE};
+
+  switch (neighbourhood) {
+    case tsp::Neighbourhood::SWAP:
+      scan_swap(matrix,
+                tabu_list,
+                solution,
+                candidates,
+                current_best_cost,
+                slice,
+                best_candidate);
+      break;
+    case tsp::Neighbourhood::TWO_OPT:
+      scan_two_opt(matrix,
+                   tabu_list,
+                   solution,
+                   prefix,
+                   candidates,
+                   symmetric,
+                   current_best_cost,
+                   slice,
+                   best_candidate);
+      break;
+    case tsp::Neighbourhood::OR_OPT:
+      scan_or_opt(matrix,
+                  tabu_list,
+                  solution,
+                  candidates,
+                  current_best_cost,
+                  slice,
+                  best_candidate);
+      break;
+  }
 
   return best_candidate;
 }
 
-constexpr static void perform_swap(WorkingSolution&     solution,
-                                   const SwapCandidate& swap) noexcept {
-  const size_t first_v_idx {solution.v_indices.at(swap.first_v)};
-  const size_t second_v_idx {solution.v_indices.at(swap.second_v)};
+// one slice per entry of partial, slices run as tasks of the shared pool and
+// the per thread winners are merged with the same tie-break as the scan
+static Candidate get_best_candidate(const tsp::CostMatrix&         matrix,
+                                    const TabuList&                tabu_list,
+                                    const WorkingSolution&         solution,
+                                    const PathPrefix&              prefix,
+                                    const util::neighbours::Lists& candidates,
+                                    tsp::Neighbourhood neighbourhood,
+                                    bool               symmetric,
+                                    int                current_best_cost,
+                                    std::vector<Candidate>& partial) noexcept {
+  const int slice_count {static_cast<int>(partial.size())};
+
+  if (slice_count == 1) {
+    return scan_slice(matrix,
+                      tabu_list,
+                      solution,
+                      prefix,
+                      candidates,
+                      neighbourhood,
+                      symmetric,
+                      current_best_cost,
+                      {.offset = 0, .stride = 1});
+  }
+
+  util::parallel::shared_pool().run(
+  slice_count, [&](int /*worker*/, int task) noexcept {
+    partial[task] = scan_slice(matrix,
+                               tabu_list,
+                               solution,
+                               prefix,
+                               candidates,
+                               neighbourhood,
+                               symmetric,
+                               current_best_cost,
+                               {.offset = task, .stride = slice_count});
+  });
+
+  return *std::ranges::min_element(partial, is_better);
+}
+
+static void update_indices(WorkingSolution& solution,
+                           int              from,
+                           int              to) noexcept {
+  for (int idx {from}; idx <= to; ++idx) {
+    solution.v_indices.at(solution.solution.path.at(idx)) = idx;
+  }
+}
+
+static void perform_swap(WorkingSolution& solution,
+                         const Candidate& swap) noexcept {
+  std::vector<int>& path {solution.solution.path};
+
+  std::swap(path.at(swap.first), path.at(swap.second));
+  update_indices(solution, swap.first, swap.first);
+  update_indices(solution, swap.second, swap.second);
+
+  if (swap.first == 0) {
+    path.back() = path.front();
+  }
+}
+
+// the path is a plain array, so a move costs one swap per reversed pair, on
+// symmetric instances the tour may be turned around and the shorter of the
+// segment and its complement is reversed, at most n / 2 swaps, asymmetric
+// ones always reverse the segment itself
+static void perform_two_opt(WorkingSolution& solution,
+                            const Candidate& move,
+                            bool             symmetric) noexcept {
+  std::vector<int>& path {solution.solution.path};
+  const int         v_count {static_cast<int>(path.size()) - 1};
+  const int         inner_length {move.second - move.first};
 
-  std::swap(solution.solution.path.at(first_v_idx),
-            solution.solution.path.at(second_v_idx));
-  std::swap(solution.v_indices.at(swap.first_v),
-            solution.v_indices.at(swap.second_v));
+  if (!symmetric || inner_length <= v_count - inner_length) {
+    std::reverse(path.begin() + move.first + 1,
+                 path.begin() + move.second + 1);
+    update_indices(solution, move.first + 1, move.second);
+    return;
+  }
 
-  if (first_v_idx == 0) {
-    solution.solution.path.back() = swap.second_v;
+  // complement runs from second + 1 around the end of the path to first
+  for (int step {0}; step < (v_count - inner_length) / 2; ++step) {
+    const int left {(move.second + 1 + step) % v_count};
+    const int right {(move.first - step + v_count) % v_count};
+    std::swap(path[left], path[right]);
+    solution.v_indices.at(path[left])  = left;
+    solution.v_indices.at(path[right]) = right;
   }
+  path.back() = path.front();
+}
+
+static void perform_or_opt(WorkingSolution& solution,
+                           const Candidate& move) noexcept {
+  std::vector<int>& path {solution.solution.path};
+  const int         last {move.first + move.length - 1};
 
-  solution.solution.cost += swap.delta_cost;
+  if (move.second > last) {
+    std::rotate(path.begin() + move.first,
+                path.begin() + last + 1,
+                path.begin() + move.second + 1);
+    update_indices(solution, move.first, move.second);
+  } else {
+    std::rotate(path.begin() + move.second + 1,
+                path.begin() + move.first,
+                path.begin() + last + 1);
+    update_indices(solution, move.second + 1, last);
+  }
 }
 
-// memory -> O(n^2 + 3 * n) >> tabu_matrix + 2 solutins -> O(n^2 + n)
-// time -> O(n^2 + 2 * n^2 * itr_count) >> nn + tabu -> O(n^2 + n^2 * itr_count)
-template<typename WorkingSolutionType, typename TabuMatrixType>
+static void perform_move(WorkingSolution&   solution,
+                         const Candidate&   move,
+                         tsp::Neighbourhood neighbourhood,
+                         bool               symmetric) noexcept {
+  switch (neighbourhood) {
+    case tsp::Neighbourhood::SWAP:
+      perform_swap(solution, move);
+      break;
+    case tsp::Neighbourhood::TWO_OPT:
+      perform_two_opt(solution, move, symmetric);
+      break;
+    case tsp::Neighbourhood::OR_OPT:
+      perform_or_opt(solution, move);
+      break;
+  }
+
+  solution.solution.cost += move.delta_cost;
+}
+
+// best tour of one search and the iterations it took
+struct Outcome {
+  tsp::Solution best;
+  int           itr_used;
+};
+
+constexpr static size_t ELITE_SIZE {8};
+constexpr static int    RESTART_ROUNDS {10};    // elite checks per search
+
+// best distinct tours found by all searches, touched only when a search
+// stagnates so a plain mutex is enough, the best cost is also kept atomic
+// for the checks made without the lock
+class ElitePool {
+public:
+  explicit ElitePool(size_t capacity) noexcept: capacity {capacity} {
+    elite.reserve(capacity + 1);
+  }
+
+  void offer(const tsp::Solution& solution) noexcept {
+    const std::scoped_lock lock {mutex};
+
+    if (elite.size() == capacity && elite.back().cost <= solution.cost) {
+      return;
+    }
+    if (std::ranges::any_of(elite, [&](const tsp::Solution& kept) noexcept {
+          return kept.cost == solution.cost && kept.path == solution.path;
+        })) {
+      return;
+    }
+
+    elite.insert(std::ranges::upper_bound(
+                 elite, solution.cost, {}, &tsp::Solution::cost),
+                 solution);
+    if (elite.size() > capacity) {
+      elite.pop_back();
+    }
+    best_cost_value.store(elite.front().cost, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] int best_cost() const noexcept {
+    return best_cost_value.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] tsp::Solution best() const noexcept {
+    const std::scoped_lock lock {mutex};
+    return elite.front();
+  }
+
+  [[nodiscard]] tsp::Solution pick(size_t index) const noexcept {
+    const std::scoped_lock lock {mutex};
+    return elite.at(index % elite.size());
+  }
+
+private:
+  mutable std::mutex         mutex;
+  std::vector<tsp::Solution> elite;
+  size_t                     capacity;
+  std::atomic<int>           best_cost_value {std::numeric_limits<int>::max()};
+};
+
+// search 0 starts from the initial tour like a single search, 1 from greedy
+// edge, even ones from nn rooted elsewhere and odd ones from a random tour,
+// the initial tour is used when the other tour does not exist
+static WorkingSolution get_start(const tsp::CostMatrix& matrix,
+                                 const tsp::GraphInfo&  graph_info,
+                                 const WorkingSolution& first_start,
+                                 int                    start,
+                                 util::rng::Xoshiro256& engine) noexcept {
+  const size_t v_count {matrix.size()};
+
+  if (start == 0) {
+    return first_start;
+  }
+
+  std::optional<tsp::Solution> tour {};
+  if (start == 1) {
+    tour = util::construct::greedy_edge(matrix, graph_info.symmetric_graph);
+  } else if (start % 2 == 0) {
+    tour = util::construct::nearest_from(
+    matrix, static_cast<int>((start / 2) % v_count));
+  } else {
+    tour = util::construct::random_tour(matrix, engine);
+  }
+
+  if (!tour.has_value()) [[unlikely]] {
+    return first_start;
+  }
+  return to_working(std::move(*tour), v_count);
+}
+
+// a few random feasible swaps on an elite tour before a restart, so the
+// restarted search does not retrace the one that found it
+static void kick(const tsp::CostMatrix& matrix,
+                 WorkingSolution&       solution,
+                 util::rng::Xoshiro256& engine) noexcept {
+  const int v_count {static_cast<int>(matrix.size())};
+  if (v_count < 4) [[unlikely]] {
+    return;
+  }
+
+  const int swap_count {std::max(2, v_count / 20)};
+
+  for (int attempt {0}, done {0};
+       done < swap_count && attempt < swap_count * 4;
+       ++attempt) {
+    const int first_pick {engine.between(0, v_count - 1)};
+    const int second_pick {engine.between(0, v_count - 1)};
+    if (first_pick == second_pick) {
+      continue;
+    }
+    const int first {std::min(first_pick, second_pick)};
+    const int second {std::max(first_pick, second_pick)};
+
+    const int delta_cost {get_delta_cost(matrix,
+                                         solution,
+                                         solution.solution.path.at(first),
+                                         solution.solution.path.at(second))};
+    if (delta_cost == std::numeric_limits<int>::max()) {
+      continue;
+    }
+
+    perform_move(solution,
+                 {.first                = first,
+                  .second               = second,
+                  .length               = 1,
+                  .delta_cost           = delta_cost,
+                  .tabu                 = false,
+                  .aspiration_criterion = false},
+                 tsp::Neighbourhood::SWAP,
+                 true);
+    ++done;
+  }
+}
+
+// memory -> O(n^2 / 2 + 3 * n) >> tabu list + 2 solutins -> O(n^2 + n)
+// time -> O(n^2 + n^2 * itr_count) >> nn + moves -> O(n^2 + n^2 * itr_count)
+// or-opt scans O(3 * n^2) moves per iteration, 2opt on asymmetric instances
+// keeps the prefix and rebuilds it from the start of the reversed segment
+template<typename WorkingSolutionType>
 requires std::is_same_v<std::remove_cvref_t<WorkingSolutionType>,
-                        WorkingSolution> &&
-         std::is_same_v<std::remove_cvref_t<TabuMatrixType>, tsp::Matrix<int>>
-static tsp::Solution algorithm(const tsp::Matrix<int>&   matrix,
-                               const std::optional<int>& optimal_cost,
-                               TabuMatrixType&&          tabu_matrix_in,
-                               WorkingSolutionType&&     starting_solution,
-                               int                       itr_count,
-                               int no_improve_stop_itr_count,
-                               int tabu_itr_count) noexcept {
-  tsp::Matrix<int> tabu_matrix {std::forward<TabuMatrixType>(tabu_matrix_in)};
+                        WorkingSolution>
+static Outcome algorithm(const tsp::CostMatrix&         matrix,
+                         const tsp::GraphInfo&          graph_info,
+                         const std::optional<int>&      optimal_cost,
+                         WorkingSolutionType&&          starting_solution,
+                         TabuList&                      tabu_list,
+                         int                            itr_count,
+                         int                            no_improve_stop_itr_count,
+                         int                            tabu_itr_count,
+                         tsp::Neighbourhood             neighbourhood,
+                         const util::neighbours::Lists& candidates,
+                         int                            thread_count,
+                         const util::anytime::Deadline& deadline,
+                         const std::atomic<bool>&       stop) noexcept {
   WorkingSolution  work {std::forward<WorkingSolutionType>(starting_solution)}; //time O(n^2) - nn
   tsp::Solution    best {work.solution};
+  PathPrefix       prefix {};
+  const bool       use_prefix {neighbourhood == tsp::Neighbourhood::TWO_OPT &&
+                               !graph_info.symmetric_graph};
+  std::vector      partial {std::vector(thread_count, NO_CANDIDATE)};
   int              no_improve_itr_count {0};
 
+  util::anytime::record(best.cost);
+
+  if (use_prefix) {
+    build_prefix(matrix, work, 0, prefix); //time O(n) - prefix sums
+  }
+
   // finish if optimal solution is nn solution
   if (optimal_cost.has_value() && best.cost == *optimal_cost) {
-    return best;
+    return {.best = best, .itr_used = 0};
   }
 
   for (int itr {0}; itr < itr_count; ++itr) {
-    const SwapCandidate best_candidate {
-      get_best_candidate(matrix, tabu_matrix, work, best.cost)}; //time O(n^2) - check all swaps
+    // out of time or another search reached the optimum
+    if (deadline.passed(itr) || stop.load(std::memory_order_relaxed))
+    [[unlikely]] {
+      return {.best = best, .itr_used = itr};
+    }
 
-    const bool can_swap {
-      !best_candidate.tabu || best_candidate.aspiration_criterion ||
-      best_candidate.delta_cost != std::numeric_limits<int>::max()};
+    const Candidate best_candidate {
+      get_best_candidate(matrix,
+                         tabu_list,
+                         work,
+                         prefix,
+                         candidates,
+                         neighbourhood,
+                         graph_info.symmetric_graph,
+                         best.cost,
+                         partial)}; //time O(n^2), O(n * k) with lists - check moves
+
+    const bool can_swap {best_candidate.delta_cost !=
+                         std::numeric_limits<int>::max()};
     const bool is_improvement {best_candidate.delta_cost < 0};
 
     if (!can_swap || !is_improvement) [[unlikely]] {
@@ -219,52 +936,170 @@ static tsp::Solution algorithm(const tsp::Matrix<int>&   matrix,
     }
 
     if (no_improve_itr_count == no_improve_stop_itr_count) [[unlikely]] {
-      return best;
+      return {.best = best, .itr_used = itr + 1};
     }
 
     if (can_swap) [[likely]] {
-      perform_swap(work, best_candidate);
-      mark_tabu(tabu_matrix,
-                best_candidate.first_v,
-                best_candidate.second_v,
-                tabu_itr_count);
+      // tabu is marked on the vertices that defined the move
+      const int first_v {work.solution.path.at(best_candidate.first)};
+      const int second_v {work.solution.path.at(best_candidate.second)};
+
+      perform_move(
+      work, best_candidate, neighbourhood, graph_info.symmetric_graph);
+      tabu_list.mark(first_v, second_v, tabu_itr_count);
+
+      // an asymmetric 2opt leaves path[0 .. first] in place
+      if (use_prefix) {
+        build_prefix(matrix, work, best_candidate.first + 1, prefix);
+      }
 
       if (is_improvement) {
         no_improve_itr_count = 0;
 
         if (work.solution.cost < best.cost) {
           best = work.solution;
+          util::anytime::record(best.cost);
 
           // finish if optimal solution is found
           if (optimal_cost.has_value() && best.cost == *optimal_cost) {
-            return best;
+            return {.best = best, .itr_used = itr + 1};
           }
         }
       }
     }
 
-    update_tabu(tabu_matrix); //time O(n^2) - update tabu
+    tabu_list.next_itr(); //time O(1) - older marks expire by themselves
   }
 
-  return best;
+  return {.best = best, .itr_used = itr_count};
+}
+
+// every start is a task of the shared pool, its neighbourhood scan then runs
+// on the same thread, the iteration budget of a search is split in rounds,
+// after each one its best goes to the elite pool, a leading search goes on
+// from its best with its tabu list until a round brings nothing, a weak one
+// restarts from a kicked elite tour with a cleared list, every search scans
+// its neighbourhood on one thread
+static tsp::Solution multi_start(const tsp::CostMatrix&         matrix,
+                                 const tsp::GraphInfo&          graph_info,
+                                 const std::optional<int>&      optimal_cost,
+                                 const WorkingSolution&         first_start,
+                                 int                            itr_count,
+                                 int                     no_improve_stop_itr_count,
+                                 int                            tabu_itr_count,
+                                 tsp::Neighbourhood             neighbourhood,
+                                 const util::neighbours::Lists& candidates,
+                                 int                            start_count,
+                                 const util::anytime::Deadline& deadline) noexcept {
+  ElitePool         elite {ELITE_SIZE};
+  std::atomic<bool> stop {false};
+
+  elite.offer(first_start.solution);
+
+  util::parallel::shared_pool().run(
+  start_count, [&](int /*worker*/, int start) noexcept {
+    util::rng::Xoshiro256 engine {util::rng::stream(start)};
+    WorkingSolution       work {
+      get_start(matrix, graph_info, first_start, start, engine)};
+    TabuList              tabu_list {matrix.size()};
+    const int             round_itr {std::max(1, itr_count / RESTART_ROUNDS)};
+    int                   itr_left {itr_count};
+    int                   own_best_cost {std::numeric_limits<int>::max()};
+    int                   restart_count {0};
+
+    while (itr_left > 0) {
+      const Outcome outcome {algorithm(matrix,
+                                       graph_info,
+                                       optimal_cost,
+                                       std::move(work),
+                                       tabu_list,
+                                       std::min(itr_left, round_itr),
+                                       no_improve_stop_itr_count,
+                                       tabu_itr_count,
+                                       neighbourhood,
+                                       candidates,
+                                       1,
+                                       deadline,
+                                       stop)};
+      itr_left -= outcome.itr_used;
+      elite.offer(outcome.best);
+
+      if (optimal_cost.has_value() && outcome.best.cost == *optimal_cost) {
+        stop.store(true, std::memory_order_relaxed);
+      }
+
+      const bool leads {outcome.best.cost <= elite.best_cost()};
+      const bool stagnated {outcome.best.cost >= own_best_cost};
+      own_best_cost = std::min(own_best_cost, outcome.best.cost);
+
+      if (stop.load(std::memory_order_relaxed) || deadline.passed(0) ||
+          outcome.itr_used == 0 || (leads && stagnated)) {
+        break;
+      }
+
+      if (leads) {
+        work = to_working(outcome.best, matrix.size());
+      } else {
+        work = to_working(elite.pick(start + restart_count), matrix.size());
+        kick(matrix, work, engine);
+        tabu_list.clear();
+        ++restart_count;
+      }
+    }
+  });
+
+  return elite.best();
 }
 
 }    // namespace ts::impl
 
 namespace ts {
 
+[[nodiscard]] int neighbour_width(
+const int              candidate_count,
+const tsp::LocalSearch local_search) noexcept {
+  return std::max(candidate_count,
+                  local_search == tsp::LocalSearch::NONE
+                  ? 0
+                  : impl::LOCAL_SEARCH_NEIGHBOURS);
+}
+
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>&   matrix,
-const tsp::GraphInfo&     graph_info,
-const std::optional<int>& optimal_cost,
-int                       itr_count,
-int                       no_improve_stop_itr_count,
-int                       tabu_itr_count) noexcept {
+const tsp::CostMatrix&         matrix,
+const tsp::GraphInfo&          graph_info,
+const std::optional<int>&      optimal_cost,
+int                            itr_count,
+int                            no_improve_stop_itr_count,
+int                            tabu_itr_count,
+tsp::Neighbourhood             neighbourhood,
+int                            candidate_count,
+const util::neighbours::Lists& neighbours,
+int                            thread_count,
+int                            start_count,
+tsp::LocalSearch               local_search,
+tsp::Construction              initial,
+int                            time_ms) noexcept {
   const size_t v_count {matrix.size()};
 
+  const util::anytime::Deadline deadline {time_ms};
+
   // param check
-  if (itr_count < 1 || no_improve_stop_itr_count < 1 || tabu_itr_count < 1)
-  [[unlikely]] {
+  if (itr_count < 1 || no_improve_stop_itr_count < 1 || tabu_itr_count < 1 ||
+      candidate_count < 0 || thread_count < 1 || start_count < 1 ||
+      time_ms < 0) [[unlikely]] {
+    return tsp::ErrorAlgorithm::INVALID_PARAM;
+  }
+
+  // starts are tasks of the shared pool and a nested run executes inline, a
+  // search of several starts could not scan on more threads
+  if (thread_count > 1 && start_count > 1) [[unlikely]] {
+    return tsp::ErrorAlgorithm::INVALID_PARAM;
+  }
+
+  // lists are never wider than n - 1
+  if (neighbours.k() <
+      std::min(neighbour_width(candidate_count, local_search),
+               std::max(static_cast<int>(v_count) - 1, 0))) [[unlikely]] {
     return tsp::ErrorAlgorithm::INVALID_PARAM;
   }
 
@@ -274,18 +1109,59 @@ int                       tabu_itr_count) noexcept {
 
   // check if path exists
   auto first_solution_result {
-    impl::get_first_solution(matrix, graph_info, optimal_cost)};
+    impl::get_first_solution(matrix, graph_info, optimal_cost, initial)};
   if (std::holds_alternative<tsp::ErrorAlgorithm>(first_solution_result)) {
     return std::get<tsp::ErrorAlgorithm>(first_solution_result);
   }
 
-  return impl::algorithm(matrix,
-                         optimal_cost,
-                         std::vector(v_count, std::vector(v_count, 0)),
-                         std::move(std::get<impl::WorkingSolution>(first_solution_result)),
-                         itr_count,
-                         no_improve_stop_itr_count,
-                         tabu_itr_count);
+  const util::neighbours::Lists candidates {
+    neighbours.narrowed(candidate_count)};
+  const std::atomic<bool> stop {false};
+
+  tsp::Solution best {};
+  if (start_count > 1) {
+    best = impl::multi_start(matrix,
+                             graph_info,
+                             optimal_cost,
+                             std::get<impl::WorkingSolution>(first_solution_result),
+                             itr_count,
+                             no_improve_stop_itr_count,
+                             tabu_itr_count,
+                             neighbourhood,
+                             candidates,
+                             start_count,
+                             deadline);
+  } else {
+    impl::TabuList      tabu_list {v_count};
+    const impl::Outcome outcome {impl::algorithm(
+      matrix,
+      graph_info,
+      optimal_cost,
+      std::move(std::get<impl::WorkingSolution>(first_solution_result)),
+      tabu_list,
+      itr_count,
+      no_improve_stop_itr_count,
+      tabu_itr_count,
+      neighbourhood,
+      candidates,
+      thread_count,
+      deadline,
+      stop)};
+    best = outcome.best;
+  }
+
+  // the best tour polished to a local optimum of the engine, the search
+  // itself starts from the constructed tour as a local optimum leaves the
+  // tabu moves too little to escape with, no lists and so no moves when off
+  const util::neighbours::Lists polish_candidates {neighbours.narrowed(
+  local_search == tsp::LocalSearch::NONE ? 0 : impl::LOCAL_SEARCH_NEIGHBOURS)};
+  util::local_search::Engine polish {
+    matrix, polish_candidates, graph_info.symmetric_graph};
+  if (polish.improve(local_search, best, 0) != 0) {
+    util::anytime::record(best.cost);
+  }
+
+  return best;
 }
 
 }    // namespace ts
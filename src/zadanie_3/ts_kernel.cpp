@@ -0,0 +1,241 @@
+#include "zadanie_3/ts_kernel.hpp"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+#if defined(_M_X64) || defined(__x86_64__)
+  #define TS_KERNEL_X86 1
+  #include <immintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #endif
+#endif
+
+#if defined(TS_KERNEL_X86) && !defined(_MSC_VER)
+  #define TS_KERNEL_AVX2 __attribute__((target("avx2")))
+#else
+  #define TS_KERNEL_AVX2
+#endif
+
+namespace ts::kernel::impl {
+
+constexpr static int NONE {std::numeric_limits<int>::max()};
+
+// fixed vertex a = path[first] with neighbours p1 -> a -> n1, swapped with
+// b = path[second] with neighbours p2 -> b -> n2, no shared edges
+struct Fixed {
+  int a;
+  int p1;
+  int n1;
+  int old_cost;    // p1 -> a -> n1
+};
+
+static Fixed fixed(const SwapRow& row) noexcept {
+  const int a {row.path[row.first]};
+  const int p1 {row.path[row.first == 0 ? row.v_count - 1 : row.first - 1]};
+  const int n1 {row.path[row.first + 1]};
+  return {.a        = a,
+          .p1       = p1,
+          .n1       = n1,
+          .old_cost = row.costs[p1 * row.stride + a] +
+                      row.costs[a * row.stride + n1]};
+}
+
+static size_t tabu_index(int first_v, int second_v) noexcept {
+  const int low {first_v < second_v ? first_v : second_v};
+  const int high {first_v < second_v ? second_v : first_v};
+  return static_cast<size_t>(high) * (high - 1) / 2 + low;
+}
+
+// evaluates positions [from, to) on top of an earlier best
+static RowBest scalar_range(const SwapRow& row,
+                            const Fixed&   fix,
+                            int            from,
+                            int            to,
+                            RowBest        best) noexcept {
+  const int*   costs {row.costs};
+  const size_t stride {row.stride};
+
+  for (int second {from}; second < to; ++second) {
+    const int b {row.path[second]};
+    const int p2 {row.path[second - 1]};
+    const int n2 {row.path[second + 1]};
+
+    const int p1_b {costs[fix.p1 * stride + b]};
+    const int b_n1 {costs[b * stride + fix.n1]};
+    const int p2_a {costs[p2 * stride + fix.a]};
+    const int a_n2 {costs[fix.a * stride + n2]};
+    if (p1_b == -1 || b_n1 == -1 || p2_a == -1 || a_n2 == -1) [[unlikely]] {
+      continue;
+    }
+
+    const int delta {p1_b + b_n1 + p2_a + a_n2 - fix.old_cost -
+                     costs[p2 * stride + b] - costs[b * stride + n2]};
+
+    const bool tabu {row.tabu_expiry[tabu_index(fix.a, b)] > row.itr};
+    if ((!tabu || delta < row.aspiration_delta) && delta < best.delta_cost) {
+      best = {.delta_cost = delta, .second = second};
+    }
+  }
+
+  return best;
+}
+
+static RowBest swap_row_scalar(const SwapRow& row) noexcept {
+  return scalar_range(
+  row, fixed(row), row.from, row.to, {.delta_cost = NONE, .second = 0});
+}
+
+#if defined(TS_KERNEL_X86)
+// 8 positions per step, costs are gathered from the flat matrix, a lane is
+// kept only if all four new edges exist and the swap is allowed, every lane
+// keeps its first minimum so the lowest position wins ties
+TS_KERNEL_AVX2 static RowBest swap_row_avx2(const SwapRow& row) noexcept {
+  constexpr static int LANES {8};
+
+  const auto fix {fixed(row)};
+  const auto stride {static_cast<int>(row.stride)};
+
+  const __m256i stride_v {_mm256_set1_epi32(stride)};
+  const __m256i a_v {_mm256_set1_epi32(fix.a)};
+  const __m256i p1_row_v {_mm256_set1_epi32(fix.p1 * stride)};
+  const __m256i a_row_v {_mm256_set1_epi32(fix.a * stride)};
+  const __m256i n1_v {_mm256_set1_epi32(fix.n1)};
+  const __m256i old_v {_mm256_set1_epi32(fix.old_cost)};
+  const __m256i missing_v {_mm256_set1_epi32(-1)};
+  const __m256i one_v {_mm256_set1_epi32(1)};
+  const __m256i itr_v {_mm256_set1_epi32(row.itr)};
+  const __m256i aspiration_v {_mm256_set1_epi32(row.aspiration_delta)};
+  const __m256i step_v {_mm256_set1_epi32(LANES)};
+
+  __m256i best_delta_v {_mm256_set1_epi32(NONE)};
+  __m256i best_second_v {_mm256_setzero_si256()};
+  __m256i second_v {
+    _mm256_add_epi32(_mm256_set1_epi32(row.from),
+                     _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))};
+
+  int second {row.from};
+  for (; second + LANES <= row.to; second += LANES) {
+    const __m256i b {_mm256_loadu_si256(
+    reinterpret_cast<const __m256i*>(row.path + second))};
+    const __m256i p2 {_mm256_loadu_si256(
+    reinterpret_cast<const __m256i*>(row.path + second - 1))};
+    const __m256i n2 {_mm256_loadu_si256(
+    reinterpret_cast<const __m256i*>(row.path + second + 1))};
+
+    const __m256i b_row {_mm256_mullo_epi32(b, stride_v)};
+    const __m256i p2_row {_mm256_mullo_epi32(p2, stride_v)};
+
+    const __m256i p1_b {_mm256_i32gather_epi32(
+    row.costs, _mm256_add_epi32(p1_row_v, b), 4)};
+    const __m256i b_n1 {_mm256_i32gather_epi32(
+    row.costs, _mm256_add_epi32(b_row, n1_v), 4)};
+    const __m256i p2_a {_mm256_i32gather_epi32(
+    row.costs, _mm256_add_epi32(p2_row, a_v), 4)};
+    const __m256i a_n2 {_mm256_i32gather_epi32(
+    row.costs, _mm256_add_epi32(a_row_v, n2), 4)};
+    const __m256i p2_b {_mm256_i32gather_epi32(
+    row.costs, _mm256_add_epi32(p2_row, b), 4)};
+    const __m256i b_n2 {_mm256_i32gather_epi32(
+    row.costs, _mm256_add_epi32(b_row, n2), 4)};
+
+    // any missing new edge makes the swap infeasible
+    const __m256i missing {_mm256_or_si256(
+    _mm256_or_si256(_mm256_cmpeq_epi32(p1_b, missing_v),
+                    _mm256_cmpeq_epi32(b_n1, missing_v)),
+    _mm256_or_si256(_mm256_cmpeq_epi32(p2_a, missing_v),
+                    _mm256_cmpeq_epi32(a_n2, missing_v)))};
+
+    const __m256i delta {_mm256_sub_epi32(
+    _mm256_add_epi32(_mm256_add_epi32(p1_b, b_n1),
+                     _mm256_add_epi32(p2_a, a_n2)),
+    _mm256_add_epi32(old_v, _mm256_add_epi32(p2_b, b_n2)))};
+
+    // tabu list index high * (high - 1) / 2 + low of the pair (a, b)
+    const __m256i low {_mm256_min_epi32(a_v, b)};
+    const __m256i high {_mm256_max_epi32(a_v, b)};
+    const __m256i tabu_idx {_mm256_add_epi32(
+    _mm256_srli_epi32(
+    _mm256_mullo_epi32(high, _mm256_sub_epi32(high, one_v)), 1),
+    low)};
+    const __m256i expiry {
+      _mm256_i32gather_epi32(row.tabu_expiry, tabu_idx, 4)};
+    const __m256i tabu {_mm256_cmpgt_epi32(expiry, itr_v)};
+    const __m256i aspiration {_mm256_cmpgt_epi32(aspiration_v, delta)};
+
+    const __m256i blocked {_mm256_or_si256(
+    missing, _mm256_andnot_si256(aspiration, tabu))};
+    const __m256i take {
+      _mm256_andnot_si256(blocked, _mm256_cmpgt_epi32(best_delta_v, delta))};
+
+    best_delta_v  = _mm256_blendv_epi8(best_delta_v, delta, take);
+    best_second_v = _mm256_blendv_epi8(best_second_v, second_v, take);
+    second_v      = _mm256_add_epi32(second_v, step_v);
+  }
+
+  alignas(32) std::array<int, LANES> deltas {};
+  alignas(32) std::array<int, LANES> seconds {};
+  _mm256_store_si256(reinterpret_cast<__m256i*>(deltas.data()), best_delta_v);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(seconds.data()), best_second_v);
+
+  RowBest best {.delta_cost = NONE, .second = 0};
+  for (int lane {0}; lane < LANES; ++lane) {
+    if (deltas[lane] < best.delta_cost ||
+        (deltas[lane] == best.delta_cost && deltas[lane] != NONE &&
+         seconds[lane] < best.second)) {
+      best = {.delta_cost = deltas[lane], .second = seconds[lane]};
+    }
+  }
+
+  // tail positions come after every vector lane, strict < keeps ties lowest
+  return scalar_range(row, fix, second, row.to, best);
+}
+
+static bool detect_avx2() noexcept {
+  #if defined(_MSC_VER)
+  std::array<int, 4> regs {};
+  __cpuid(regs.data(), 0);
+  if (regs[0] < 7) {
+    return false;
+  }
+
+  // avx and os saved ymm registers are needed next to the avx2 bit
+  __cpuid(regs.data(), 1);
+  const bool osxsave {(regs[2] & (1 << 27)) != 0};
+  const bool avx {(regs[2] & (1 << 28)) != 0};
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+    return false;
+  }
+
+  __cpuidex(regs.data(), 7, 0);
+  return (regs[1] & (1 << 5)) != 0;
+  #else
+  return __builtin_cpu_supports("avx2") != 0;
+  #endif
+}
+#endif
+
+}    // namespace ts::kernel::impl
+
+namespace ts::kernel {
+
+[[nodiscard]] bool uses_avx2() noexcept {
+#if defined(TS_KERNEL_X86)
+  static const bool avx2 {impl::detect_avx2()};
+  return avx2;
+#else
+  return false;
+#endif
+}
+
+[[nodiscard]] RowBest swap_row(const SwapRow& row) noexcept {
+#if defined(TS_KERNEL_X86)
+  if (uses_avx2()) [[likely]] {
+    return impl::swap_row_avx2(row);
+  }
+#endif
+  return impl::swap_row_scalar(row);
+}
+
+}    // namespace ts::kernel
@@ -1,97 +1,66 @@
 #include "zadanie_4/gen.hpp"
 
+#include "zadanie_4/gen_population.hpp"
+
+#include "anytime.hpp"
+#include "construct.hpp"
+#include "local_search.hpp"
+#include "neighbours.hpp"
+#include "parallel.hpp"
+#include "rng.hpp"
+#include "spsc.hpp"
 #include "util.hpp"
 #include "zadanie_1/nn.hpp"
 
-#include <compare>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <random>
-#include <set>
+#include <span>
 #include <utility>
 #include <variant>
 #include <vector>
 
 namespace gen::impl {
 
-struct Chromosome {
-  std::vector<int> vertices;
-  std::vector<int> path;
-  int              cost;
-
-  constexpr std::weak_ordering operator<=>(
-  const Chromosome& other) const noexcept {
-    // if can compare cost return that, else fallback to bad but fast hash
-
-    if (const auto result = cost <=> other.cost;
-        result != std::strong_ordering::equal) {
-      return result;
-    }
-
-    if (const auto result = path.at(0) <=> other.path.at(0);
-        result != std::strong_ordering::equal) {
-      return result;
-    }
-
-    if (const auto result = path.at(1) <=> other.path.at(1);
-        result != std::strong_ordering::equal) {
-      return result;
-    }
-
-    return path.at(path.size() / 2) <=> other.path.at(other.path.size() / 2);
-  }
-};
+using population::Population;
+using population::Slot;
 
-// population is always sorted by cost
-using Population = std::set<Chromosome>;
-
-// O(n^2 + population_count * log(population_count)) >> nn + init_population -> O(n^2 + population_count * log(population_count))
-// memory -> O(n^2 + population_count) >> nn + population -> O(n^2 + population_count)
-[[nodiscard]] static std::variant<Population, tsp::ErrorAlgorithm>
-init_population(const tsp::Matrix<int>&   matrix,
-                const tsp::GraphInfo&     graph_info,
-                const std::optional<int>& optimal_cost,
-                auto&                     rand_src,
-                int                       population_count) noexcept {
+// O(population_count * population_count) >> init_population -> O(population_count^2)
+// memory -> O(population_count * n) >> population -> O(population_count * n)
+static void init_population(const tsp::CostMatrix& matrix,
+                            const tsp::Solution&   initial_tour,
+                            auto&                  rand_src,
+                            Population&            population,
+                            int                    population_count) noexcept {
   const int v_count {static_cast<int>(matrix.size())};
 
-  auto nn_result {nn::run(matrix, graph_info, optimal_cost)}; //O(n^2) -  nn
-  if (std::holds_alternative<tsp::ErrorAlgorithm>(nn_result)) [[unlikely]] {
-    return std::get<tsp::ErrorAlgorithm>(nn_result);
+  // first chromosome is always the initial tour
+  const Slot first_slot {population.acquire()};
+  std::ranges::copy(initial_tour.path, population.path(first_slot).begin());
+  for (int i {0}; i < v_count; ++i) {
+    population.vertices(first_slot)[initial_tour.path.at(i)] = i;
   }
+  population.cost(first_slot) = initial_tour.cost;
+  population.rehash(first_slot);
+  population.insert(first_slot);
 
-  const Chromosome nn_chromosome {[&nn_result, &v_count]() noexcept {
-    tsp::Solution nn_solution {std::move(std::get<tsp::Solution>(nn_result))};
-
-    std::vector vertices(v_count, -1);
-    for (int i {0}; i < v_count; ++i) {
-      vertices.at(nn_solution.path.at(i)) = i;
-    }
-
-    return Chromosome {.vertices = std::move(vertices),
-                       .path     = std::move(nn_solution.path),
-                       .cost     = nn_solution.cost};
-  }()};
-
-  // first chromosome is always the nn solution
-  Population population {{nn_chromosome}};
-
-  // the next chromosomes are generated by swapping two random vertices in the nn solution
-  std::uniform_int_distribution dist {1, v_count - 1};
+  // the next chromosomes are generated by swapping two random vertices in the initial tour
   while (population.size() != population_count) [[likely]] {
-    const int first_idx {dist(rand_src)};
-    const int second_idx {dist(rand_src)};
+    const int first_idx {rand_src.between(1, v_count - 1)};
+    const int second_idx {rand_src.between(1, v_count - 1)};
 
-    const auto first_v {nn_chromosome.path.at(first_idx)};
-    const auto second_v {nn_chromosome.path.at(second_idx)};
+    const std::span<const int> first_path {std::as_const(population).path(first_slot)};
 
-    const int first_new_cost_left {
-      matrix.at(nn_chromosome.path.at(second_idx - 1)).at(first_v)};
-    const int first_new_cost_right {
-      matrix.at(first_v).at(nn_chromosome.path.at(second_idx + 1))};
-    const int second_new_cost_left {
-      matrix.at(nn_chromosome.path.at(first_idx - 1)).at(second_v)};
-    const int second_new_cost_right {
-      matrix.at(second_v).at(nn_chromosome.path.at(first_idx + 1))};
+    const auto first_v {first_path[first_idx]};
+    const auto second_v {first_path[second_idx]};
+
+    const int first_new_cost_left {matrix(first_path[second_idx - 1], first_v)};
+    const int first_new_cost_right {matrix(first_v, first_path[second_idx + 1])};
+    const int second_new_cost_left {matrix(first_path[first_idx - 1], second_v)};
+    const int second_new_cost_right {matrix(second_v, first_path[first_idx + 1])};
 
     if (first_new_cost_left == -1 || first_new_cost_right == -1 ||
         second_new_cost_left == -1 || second_new_cost_right == -1)
@@ -99,42 +68,35 @@ init_population(const tsp::Matrix<int>&   matrix,
       continue;
     }
 
-    const int old_cost {
-      matrix.at(nn_chromosome.path.at(first_idx - 1)).at(first_v) +
-      matrix.at(first_v).at(nn_chromosome.path.at(first_idx + 1)) +
-      matrix.at(nn_chromosome.path.at(second_idx - 1)).at(second_v) +
-      matrix.at(second_v).at(nn_chromosome.path.at(second_idx + 1))};
+    const int old_cost {matrix(first_path[first_idx - 1], first_v) +
+                        matrix(first_v, first_path[first_idx + 1]) +
+                        matrix(first_path[second_idx - 1], second_v) +
+                        matrix(second_v, first_path[second_idx + 1])};
 
     const int cost_diff {first_new_cost_left + first_new_cost_right +
                          second_new_cost_left + second_new_cost_right -
                          old_cost};
 
-    population.emplace([&nn_chromosome,
-                        &first_v,
-                        &first_idx,
-                        &second_v,
-                        &second_idx,
-                        &cost_diff]() noexcept { //O(log(population_count)) - insert
-      Chromosome chromosome {.vertices = nn_chromosome.vertices,
-                             .path     = nn_chromosome.path,
-                             .cost     = nn_chromosome.cost + cost_diff};
+    const Slot slot {population.acquire()};
+    population.copy(first_slot, slot);
+    population.cost(slot) += cost_diff;
 
-      std::swap(chromosome.path.at(first_idx), chromosome.path.at(second_idx));
-      std::swap(chromosome.vertices.at(first_v),
-                chromosome.vertices.at(second_v));
+    std::swap(population.path(slot)[first_idx],
+              population.path(slot)[second_idx]);
+    std::swap(population.vertices(slot)[first_v],
+              population.vertices(slot)[second_v]);
+    population.rehash(slot); // O(n) - same as the copy
 
-      return chromosome;
-    }());
+    population.insert(slot); //O(population_count) - sorted insert
   }
-
-  return population;
 }
 
-[[nodiscard]] static std::optional<Chromosome> crossover(
-const tsp::Matrix<int>& matrix,
+[[nodiscard]] static std::optional<Slot> splice_crossover(
+const tsp::CostMatrix&  matrix,
 auto&                   rand_src,
-const Chromosome&       parent_base,
-const Chromosome&       parent2,
+Population&             population,
+Slot                    parent_base,
+Slot                    parent2,
 int                     max_v_count_crossover) noexcept {
   // crossover is done by selecting a random vertex from the first parent and
   // then selecting a random number of vertices from the second parent to
@@ -143,260 +105,831 @@ int                     max_v_count_crossover) noexcept {
 
   const int v_count {static_cast<int>(matrix.size())};
 
-  Chromosome child {.vertices = parent_base.vertices,
-                    .path     = parent_base.path,
-                    .cost     = parent_base.cost};
+  const Slot child {population.acquire()};
+  population.copy(parent_base, child);
 
-  std::uniform_int_distribution dist {};
+  const std::span<int>       child_path {population.path(child)};
+  const std::span<int>       child_vertices {population.vertices(child)};
+  const std::span<const int> parent2_path {
+    std::as_const(population).path(parent2)};
+  const std::span<const int> parent2_vertices {
+    std::as_const(population).vertices(parent2)};
 
-  const int first_idx {
-    dist(rand_src,
-         std::uniform_int_distribution<>::param_type {1, v_count - 1})};
-  const auto first_v {child.path.at(first_idx)};
+  const int  first_idx {rand_src.between(1, v_count - 1)};
+  const auto first_v {child_path[first_idx]};
 
-  const auto second_idx {parent2.vertices.at(first_v)};
+  const auto second_idx {parent2_vertices[first_v]};
 
-  const auto count {dist(
-  rand_src,
-  std::uniform_int_distribution<>::param_type {
-    1,
-    std::min(
-    {v_count - second_idx, v_count - first_idx, max_v_count_crossover})})};
+  const auto count {rand_src.between(
+  1,
+  std::min({v_count - second_idx, v_count - first_idx, max_v_count_crossover}))};
 
   for (int i {1}; i < count; ++i) {
     const int base_idx {first_idx + i};
     const int other_idx {second_idx + i};
 
-    const int base_v {child.path.at(base_idx)};
-    const int other_v {parent2.path.at(other_idx)};
+    const int base_v {child_path[base_idx]};
+    const int other_v {parent2_path[other_idx]};
 
     if (base_v == other_v) [[unlikely]] {
       continue;
     }
 
-    if (child.vertices.at(other_v) < first_idx ||
-        child.vertices.at(other_v) >= first_idx + count) {
+    if (child_vertices[other_v] < first_idx ||
+        child_vertices[other_v] >= first_idx + count) {
+      population.release(child);
       return std::nullopt;
     }
 
-    const int new_cost_left {
-      matrix.at(child.path.at(base_idx - 1)).at(other_v)};
-    const int new_cost_right {
-      matrix.at(other_v).at(child.path.at(base_idx + 1))};
+    const int new_cost_left {matrix(child_path[base_idx - 1], other_v)};
+    const int new_cost_right {matrix(other_v, child_path[base_idx + 1])};
 
     if (new_cost_left == -1 || new_cost_right == -1) [[unlikely]] {
+      population.release(child);
       return std::nullopt;
     }
 
-    const int old_cost {matrix.at(child.path.at(base_idx - 1)).at(base_v) +
-                        matrix.at(base_v).at(child.path.at(base_idx + 1))};
+    const int old_cost {matrix(child_path[base_idx - 1], base_v) +
+                        matrix(base_v, child_path[base_idx + 1])};
 
     const int cost_diff {new_cost_left + new_cost_right - old_cost};
 
-    child.path.at(base_idx)     = other_v;
-    child.vertices.at(other_v)  = base_idx;
-    child.cost                 += cost_diff;
+    population.hash(child) ^=
+    population.edge_key(child_path[base_idx - 1], base_v) ^
+    population.edge_key(base_v, child_path[base_idx + 1]) ^
+    population.edge_key(child_path[base_idx - 1], other_v) ^
+    population.edge_key(other_v, child_path[base_idx + 1]);
+
+    child_path[base_idx]            = other_v;
+    child_vertices[other_v]         = base_idx;
+    population.cost(child)         += cost_diff;
+  }
+
+  return child;
+}
+
+// buffers shared by the crossovers of one run, sized once
+struct Scratch {
+  std::vector<char> used;         // vertex already placed in the child
+  std::vector<int>  neighbours;   // erx: up to 4 parent neighbours per vertex
+  std::vector<int>  neighbour_counts;
+};
+
+constexpr static int ERX_MAX_NEIGHBOURS {4};
+
+[[nodiscard]] static Scratch make_scratch(int v_count) noexcept {
+  return {.used             = std::vector<char>(v_count, 0),
+          .neighbours       = std::vector<int>(v_count * ERX_MAX_NEIGHBOURS),
+          .neighbour_counts = std::vector<int>(v_count)};
+}
+
+// child path written front to back, the cost and hash grow with every placed
+// vertex
+class ChildWriter {
+public:
+  ChildWriter(const tsp::CostMatrix& matrix,
+              Population&            population,
+              Slot                   child) noexcept:
+    matrix {matrix},
+    population {population},
+    path {population.path(child)},
+    vertices {population.vertices(child)},
+    cost {population.cost(child)},
+    hash {population.hash(child)} {
+    cost = 0;
+    hash = 0;
+  }
+
+  // false if the edge from the previous vertex is missing
+  [[nodiscard]] bool push(int vertex) noexcept {
+    if (length != 0) {
+      const int edge_cost {matrix(path[length - 1], vertex)};
+      if (edge_cost == -1) [[unlikely]] {
+        return false;
+      }
+      cost += edge_cost;
+      hash ^= population.edge_key(path[length - 1], vertex);
+    }
+    path[length]     = vertex;
+    vertices[vertex] = length;
+    ++length;
+    return true;
+  }
+
+  // closes the tour, false if the edge back to the start is missing
+  [[nodiscard]] bool close() noexcept {
+    const int edge_cost {matrix(path[length - 1], path[0])};
+    if (edge_cost == -1) [[unlikely]] {
+      return false;
+    }
+    cost         += edge_cost;
+    hash         ^= population.edge_key(path[length - 1], path[0]);
+    path[length]  = path[0];
+    return true;
+  }
+
+private:
+  const tsp::CostMatrix& matrix;
+  const Population&      population;
+  std::span<int>         path;
+  std::span<int>         vertices;
+  int&                   cost;
+  uint64_t&              hash;
+  int                    length {0};
+};
+
+// length of the segment taken from the second parent
+[[nodiscard]] static int segment_length(auto& rand_src,
+                                        int   v_count,
+                                        int   max_v_count_crossover) noexcept {
+  return rand_src.between(
+  1, std::max(1, std::min(v_count - 1, max_v_count_crossover)));
+}
+
+// order crossover, a segment of the second parent followed by the other
+// vertices in the order of the base parent, always a permutation
+[[nodiscard]] static std::optional<Slot> ox_crossover(
+const tsp::CostMatrix& matrix,
+auto&                  rand_src,
+Population&            population,
+Scratch&               scratch,
+Slot                   parent_base,
+Slot                   parent2,
+int                    max_v_count_crossover) noexcept {
+  const int v_count {static_cast<int>(matrix.size())};
+
+  const Slot           child {population.acquire()};
+  ChildWriter          writer {matrix, population, child};
+  const std::span<const int> base_path {std::as_const(population).path(parent_base)};
+  const std::span<const int> other_path {std::as_const(population).path(parent2)};
+
+  const int start {rand_src.between(0, v_count - 1)};
+  const int length {segment_length(rand_src, v_count, max_v_count_crossover)};
+
+  std::ranges::fill(scratch.used, 0);
+
+  bool valid {true};
+  for (int i {0}; i < length && valid; ++i) {
+    const int vertex {other_path[(start + i) % v_count]};
+    scratch.used[vertex] = 1;
+    valid                = writer.push(vertex);
   }
 
+  // base order continues after the place where the segment ends
+  for (int i {0}; i < v_count && valid; ++i) {
+    const int vertex {base_path[(start + length + i) % v_count]};
+    if (scratch.used[vertex] == 0) {
+      valid = writer.push(vertex);
+    }
+  }
+
+  if (!valid || !writer.close()) [[unlikely]] {
+    population.release(child);
+    return std::nullopt;
+  }
   return child;
 }
 
-static std::optional<Chromosome> mutate(const tsp::Matrix<int>& matrix,
-                                        auto&                   rand_src,
-                                        const Chromosome&       base) noexcept {
+// partially mapped crossover, a segment of the second parent stays in place,
+// other positions take the base vertex mapped through the segment until it
+// is free, always a permutation
+[[nodiscard]] static std::optional<Slot> pmx_crossover(
+const tsp::CostMatrix& matrix,
+auto&                  rand_src,
+Population&            population,
+Scratch&               scratch,
+Slot                   parent_base,
+Slot                   parent2,
+int                    max_v_count_crossover) noexcept {
+  const int v_count {static_cast<int>(matrix.size())};
+
+  const Slot           child {population.acquire()};
+  ChildWriter          writer {matrix, population, child};
+  const std::span<const int> base_path {std::as_const(population).path(parent_base)};
+  const std::span<const int> other_path {std::as_const(population).path(parent2)};
+  const std::span<const int> other_vertices {
+    std::as_const(population).vertices(parent2)};
+
+  const int length {segment_length(rand_src, v_count, max_v_count_crossover)};
+  const int start {rand_src.between(0, v_count - length)};
+
+  std::ranges::fill(scratch.used, 0);
+  for (int i {start}; i < start + length; ++i) {
+    scratch.used[other_path[i]] = 1;
+  }
+
+  bool valid {true};
+  for (int i {0}; i < v_count && valid; ++i) {
+    int vertex {other_path[i]};
+    if (i < start || i >= start + length) {
+      vertex = base_path[i];
+      while (scratch.used[vertex] != 0) {
+        vertex = base_path[other_vertices[vertex]];
+      }
+    }
+    valid = writer.push(vertex);
+  }
+
+  if (!valid || !writer.close()) [[unlikely]] {
+    population.release(child);
+    return std::nullopt;
+  }
+  return child;
+}
+
+// edge recombination, the tour follows edges of either parent preferring the
+// neighbour with the fewest free neighbours left, when none is free the
+// cheapest free vertex is taken, on asymmetric instances only successors count
+[[nodiscard]] static std::optional<Slot> erx_crossover(
+const tsp::CostMatrix& matrix,
+const tsp::GraphInfo&  graph_info,
+Population&            population,
+Scratch&               scratch,
+Slot                   parent_base,
+Slot                   parent2) noexcept {
+  const int v_count {static_cast<int>(matrix.size())};
+
+  std::ranges::fill(scratch.neighbour_counts, 0);
+  const auto add_neighbour {[&scratch](int vertex, int neighbour) noexcept {
+    int* const list {scratch.neighbours.data() + vertex * ERX_MAX_NEIGHBOURS};
+    int&       count {scratch.neighbour_counts[vertex]};
+    if (std::find(list, list + count, neighbour) == list + count) {
+      list[count++] = neighbour;
+    }
+  }};
+
+  for (const Slot parent : {parent_base, parent2}) {
+    const std::span<const int> path {std::as_const(population).path(parent)};
+    for (int i {0}; i < v_count; ++i) {
+      add_neighbour(path[i], path[i + 1]);
+      if (graph_info.symmetric_graph) {
+        add_neighbour(path[i + 1], path[i]);
+      }
+    }
+  }
+
+  const auto free_neighbours {[&scratch](int vertex) noexcept {
+    const int* const list {scratch.neighbours.data() +
+                           vertex * ERX_MAX_NEIGHBOURS};
+    return static_cast<int>(
+    std::count_if(list,
+                  list + scratch.neighbour_counts[vertex],
+                  [&scratch](int v) noexcept { return scratch.used[v] == 0; }));
+  }};
+
+  const Slot  child {population.acquire()};
+  ChildWriter writer {matrix, population, child};
+
+  std::ranges::fill(scratch.used, 0);
+
+  int current {std::as_const(population).path(parent_base)[0]};
+  scratch.used[current] = 1;
+  bool valid {writer.push(current)};
+
+  for (int step {1}; step < v_count && valid; ++step) {
+    int next {-1};
+    int next_free {0};
+
+    const int* const list {scratch.neighbours.data() +
+                           current * ERX_MAX_NEIGHBOURS};
+    for (int i {0}; i < scratch.neighbour_counts[current]; ++i) {
+      const int candidate {list[i]};
+      if (scratch.used[candidate] != 0 || matrix(current, candidate) == -1) {
+        continue;
+      }
+
+      const int candidate_free {free_neighbours(candidate)};
+      if (next == -1 || candidate_free < next_free ||
+          (candidate_free == next_free &&
+           matrix(current, candidate) < matrix(current, next))) {
+        next      = candidate;
+        next_free = candidate_free;
+      }
+    }
+
+    // no parent edge left, O(n) fallback to the cheapest free vertex
+    if (next == -1) [[unlikely]] {
+      for (int candidate {0}; candidate < v_count; ++candidate) {
+        if (scratch.used[candidate] != 0 || matrix(current, candidate) == -1) {
+          continue;
+        }
+        if (next == -1 || matrix(current, candidate) < matrix(current, next)) {
+          next = candidate;
+        }
+      }
+    }
+
+    if (next == -1) [[unlikely]] {
+      valid = false;
+      break;
+    }
+
+    scratch.used[next] = 1;
+    valid              = writer.push(next);
+    current            = next;
+  }
+
+  if (!valid || !writer.close()) [[unlikely]] {
+    population.release(child);
+    return std::nullopt;
+  }
+  return child;
+}
+
+[[nodiscard]] static std::optional<Slot> crossover(
+const tsp::CostMatrix& matrix,
+const tsp::GraphInfo&  graph_info,
+auto&                  rand_src,
+Population&            population,
+Scratch&               scratch,
+tsp::Crossover         kind,
+Slot                   parent_base,
+Slot                   parent2,
+int                    max_v_count_crossover) noexcept {
+  switch (kind) {
+    case tsp::Crossover::SPLICE:
+      return splice_crossover(
+      matrix, rand_src, population, parent_base, parent2, max_v_count_crossover);
+    case tsp::Crossover::OX:
+      return ox_crossover(matrix,
+                          rand_src,
+                          population,
+                          scratch,
+                          parent_base,
+                          parent2,
+                          max_v_count_crossover);
+    case tsp::Crossover::PMX:
+      return pmx_crossover(matrix,
+                           rand_src,
+                           population,
+                           scratch,
+                           parent_base,
+                           parent2,
+                           max_v_count_crossover);
+    case tsp::Crossover::ERX:
+      return erx_crossover(
+      matrix, graph_info, population, scratch, parent_base, parent2);
+  }
+  return std::nullopt;
+}
+
+// neighbour list length used by the local search of children
+constexpr static int LOCAL_SEARCH_NEIGHBOURS {8};
+
+// memetic step, the child is improved in place before it joins the population
+static void improve(Population&                 population,
+                    Slot                        child,
+                    util::local_search::Engine& engine,
+                    tsp::LocalSearch            local_search,
+                    int                         local_search_moves) noexcept {
+  if (engine.improve(local_search,
+                     population.path(child),
+                     population.vertices(child),
+                     population.cost(child),
+                     local_search_moves) != 0) {
+    population.rehash(child);
+  }
+}
+
+static std::optional<Slot> mutate(const tsp::CostMatrix&  matrix,
+                                  auto&                   rand_src,
+                                  Population&             population,
+                                  Slot                    base) noexcept {
   // mutation is done by selecting a random vertex and swapping it with the
   // first vertex in the path, invalid mutations are discarded
 
   const int v_count {static_cast<int>(matrix.size())};
 
-  std::uniform_int_distribution dist {2, v_count - 2};
+  // acquire may grow the gene storage, spans are taken after it
+  const Slot mutated {population.acquire()};
+  population.copy(base, mutated);
+
+  const std::span<const int> base_path {std::as_const(population).path(base)};
 
-  const int swap_idx {dist(rand_src)};
-  const int swap_v {base.path.at(swap_idx)};
-  const int first_v {base.path.at(0)};
+  const int swap_idx {rand_src.between(2, v_count - 2)};
+  const int swap_v {base_path[swap_idx]};
+  const int first_v {base_path[0]};
 
-  const int new_cost_left_s {matrix.at(base.path.at(v_count - 1)).at(swap_v)};
-  const int new_cost_right_s {matrix.at(swap_v).at(base.path.at(1))};
+  const int new_cost_left_s {matrix(base_path[v_count - 1], swap_v)};
+  const int new_cost_right_s {matrix(swap_v, base_path[1])};
 
-  const int new_cost_left_in {
-    matrix.at(base.path.at(swap_idx - 1)).at(first_v)};
-  const int new_cost_right_in {
-    matrix.at(first_v).at(base.path.at(swap_idx + 1))};
+  const int new_cost_left_in {matrix(base_path[swap_idx - 1], first_v)};
+  const int new_cost_right_in {matrix(first_v, base_path[swap_idx + 1])};
 
   if (new_cost_left_s == -1 || new_cost_right_s == -1 ||
       new_cost_left_in == -1 || new_cost_right_in == -1) [[unlikely]] {
+    population.release(mutated);
     return std::nullopt;
   }
 
-  const int old_cost {
-    matrix.at(base.path.at(swap_idx - 1)).at(base.path.at(swap_idx)) +
-    matrix.at(base.path.at(swap_idx)).at(base.path.at(swap_idx + 1)) +
-    matrix.at(base.path.at(v_count - 1)).at(first_v) +
-    matrix.at(first_v).at(base.path.at(1))};
+  const int old_cost {matrix(base_path[swap_idx - 1], base_path[swap_idx]) +
+                      matrix(base_path[swap_idx], base_path[swap_idx + 1]) +
+                      matrix(base_path[v_count - 1], first_v) +
+                      matrix(first_v, base_path[1])};
 
   const int cost_diff {new_cost_left_s + new_cost_right_s + new_cost_left_in +
                        new_cost_right_in - old_cost};
 
-  Chromosome new_chromosome {.vertices = base.vertices,
-                             .path     = base.path,
-                             .cost     = base.cost + cost_diff};
-
-  std::swap(new_chromosome.path.at(swap_idx), new_chromosome.path.at(0));
-  new_chromosome.path.at(v_count) = swap_v;
-  std::swap(new_chromosome.vertices.at(swap_v),
-            new_chromosome.vertices.at(first_v));
-
-  return new_chromosome;
+  population.cost(mutated) += cost_diff;
+  population.hash(mutated) ^=
+  population.edge_key(base_path[v_count - 1], first_v) ^
+  population.edge_key(first_v, base_path[1]) ^
+  population.edge_key(base_path[swap_idx - 1], swap_v) ^
+  population.edge_key(swap_v, base_path[swap_idx + 1]) ^
+  population.edge_key(base_path[v_count - 1], swap_v) ^
+  population.edge_key(swap_v, base_path[1]) ^
+  population.edge_key(base_path[swap_idx - 1], first_v) ^
+  population.edge_key(first_v, base_path[swap_idx + 1]);
+
+  const std::span<int> path {population.path(mutated)};
+  const std::span<int> vertices {population.vertices(mutated)};
+
+  std::swap(path[swap_idx], path[0]);
+  path[v_count] = swap_v;
+  std::swap(vertices[swap_v], vertices[first_v]);
+
+  return mutated;
 }
 
-static void cut(Population& population, int target_count) noexcept {
-  // cut the last chromosomes from the population to match the target count
-
-  population.erase(
-  std::ranges::next(population.begin(), target_count, population.end()),
-  population.end());
-}
-
-// O(children_per_itr * log(population_size + children_per_itr) + children_per_itr * (children_per_itr + population_size)) >>
-// O(children_per_itr * (log(population_size + children_per_itr) + children_per_itr + population_size)) >>
-// O(children_per_itr^2 + children_per_itr * (log(population_size + children_per_itr) + population_size))
-// mem O(children_per_itr)
-static void reproduce(const tsp::Matrix<int>& matrix,
+// O(children_per_itr * (population_size + children_per_itr) + children_per_itr * n) >>
+// O(children_per_itr * (population_size + children_per_itr + n))
+// mem O(children_per_itr) slots, reused between iterations
+static void reproduce(const tsp::CostMatrix&  matrix,
+                      const tsp::GraphInfo&   graph_info,
                       auto&                   rand_src,
                       Population&             population,
+                      Scratch&                scratch,
+                      std::vector<Slot>&      children,
+                      tsp::Crossover          crossover_kind,
+                      util::local_search::Engine& engine,
+                      tsp::LocalSearch        local_search,
+                      int                     local_search_moves,
                       int                     children_per_itr,
                       int                     children_per_pair,
                       int                     max_v_count_crossover) noexcept {
   constexpr static int MAX_RETIRES_PER_OFFSPRING {10};
 
-  std::uniform_int_distribution dist {};
-
-  std::vector<Chromosome> children {}; // mem O(children_per_itr)
-  children.reserve(children_per_itr);
+  children.clear();
 
   // only the first half of the population is used as parent base, the second
   // half is used as second parent
   while (children.size() != children_per_itr) [[likely]] {
-    const auto first_parent_itr {
-      std::next(population.begin(), // O(population_size + children_per_itr)
-                dist(rand_src,
-                     std::uniform_int_distribution<>::param_type {
-                       0,
-                       static_cast<int>(population.size() / 2)}))};
-
-    const auto second_parent_itr {
-      std::prev(population.end(), // O(population_size + children_per_itr)
-                dist(rand_src,
-                     std::uniform_int_distribution<>::param_type {
-                       1,
-                       static_cast<int>(population.size() / 2) - 1}))};
+    const Slot first_parent {population.at( // O(1) - rank
+    rand_src.between(0, static_cast<int>(population.size() / 2)))};
+
+    const Slot second_parent {population.at( // O(1) - rank
+    population.size() -
+    rand_src.between(1, static_cast<int>(population.size() / 2) - 1))};
 
     for (int offspring {0}, attempts {0};
          offspring < children_per_pair &&
          attempts < MAX_RETIRES_PER_OFFSPRING &&
          children.size() < children_per_itr;
          ++attempts) {
-      auto child {crossover(matrix,
-                            rand_src,
-                            *first_parent_itr,
-                            *second_parent_itr,
-                            max_v_count_crossover)};
+      const auto child {crossover(matrix,
+                                  graph_info,
+                                  rand_src,
+                                  population,
+                                  scratch,
+                                  crossover_kind,
+                                  first_parent,
+                                  second_parent,
+                                  max_v_count_crossover)};
 
       if (child.has_value()) {
+        improve(population,
+                *child,
+                engine,
+                local_search,
+                local_search_moves); // O(moves * (k + n))
         ++offspring;
         attempts = -1;
-        children.emplace_back(std::move(child.value()));
+        children.push_back(*child);
       }
     }
   }
 
-  for (auto& child : children) { // O(children_per_itr * log(population_size + children_per_itr))
-    population.emplace(std::move(child));
+  for (const Slot child : children) { // O(children_per_itr * (population_size + children_per_itr))
+    population.insert(child);
   }
 }
 
-// O(n^2 + logpop_size * population_count + itr_count * (children_per_itr^2 + children_per_itr * (log(population_size + children_per_itr) + population_size) + mutations_per_1000 * (population_size + children_per_itr)))
-// mem O(population_size * n + children_per_itr * n)
-[[nodiscard]] static std::variant<tsp::Solution, tsp::ErrorAlgorithm> algorithm(
-const tsp::Matrix<int>&   matrix,
-const tsp::GraphInfo&     graph_info,
-const std::optional<int>& optimal_cost,
-int                       count_of_itr,
-int                       population_size,
-int                       children_per_itr,
-int                       max_children_per_pair,
-int                       max_v_count_crossover,
-int                       mutations_per_1000) noexcept {
-  std::mt19937_64 rand_src {std::random_device {}()};
-
-  auto population_result {init_population(matrix, // O(n^2 + population_count * logpop_size), mem O(population_size * n)
-                                          graph_info,
-                                          optimal_cost,
-                                          rand_src,
-                                          population_size)};
-  if (std::holds_alternative<tsp::ErrorAlgorithm>(population_result))
-  [[unlikely]] {
-    return std::get<tsp::ErrorAlgorithm>(population_result);
+// chromosome passed between islands, buffers are sized once in the queue
+struct Migrant {
+  std::vector<int> path;
+  int              cost;
+  uint64_t         hash;
+};
+
+using MigrantQueue = util::spsc::Queue<Migrant>;
+
+// generations a full queue may lag behind before migrants are dropped
+constexpr static int MIGRATION_BACKLOG {4};
+
+// ring link of one island, incoming is filled by the previous island only
+// and outgoing drained by the next one only
+struct Migration {
+  MigrantQueue& incoming;
+  MigrantQueue& outgoing;
+  int           interval;
+  int           count;
+};
+
+static void migrate(Population& population, Migration& migration) noexcept {
+  const int sent {std::min(migration.count,
+                           static_cast<int>(population.size()))};
+  for (int rank {0}; rank < sent; ++rank) {
+    const Slot slot {population.at(rank)};
+    // a full queue means the next island is behind, the migrant is dropped
+    migration.outgoing.try_push([&population, slot](Migrant& migrant) noexcept {
+      std::ranges::copy(std::as_const(population).path(slot),
+                        migrant.path.begin());
+      migrant.cost = population.cost(slot);
+      migrant.hash = population.hash(slot);
+    });
   }
 
-  Population population {std::move(std::get<Population>(population_result))};
+  const auto receive {[&population](const Migrant& migrant) noexcept {
+    const int  v_count {static_cast<int>(migrant.path.size()) - 1};
+    const Slot slot {population.acquire()};
+    std::ranges::copy(migrant.path, population.path(slot).begin());
+    for (int i {0}; i < v_count; ++i) {
+      population.vertices(slot)[migrant.path[i]] = i;
+    }
+    population.cost(slot) = migrant.cost;
+    population.hash(slot) = migrant.hash;
+    population.insert(slot);
+  }};
+  while (migration.incoming.try_pop(receive)) {
+  }
+}
 
-  std::uniform_int_distribution mutation_dist {0, 1};
-  std::geometric_distribution   mutated_dist {0.5};
+// one population from start to end, migration is nullptr without islands
+// O(n^2 + population_size^2 + itr_count * (children_per_itr * (population_size + children_per_itr + n) + mutations_per_1000 * (population_size + children_per_itr + n)))
+// mem O((population_size + children_per_itr + mutations_per_1000) * n) in one flat buffer
+[[nodiscard]] static std::variant<tsp::Solution, tsp::ErrorAlgorithm> evolve(
+const tsp::CostMatrix&         matrix,
+const tsp::GraphInfo&          graph_info,
+const std::optional<int>&      optimal_cost,
+const tsp::Solution&           initial_tour,
+util::rng::Xoshiro256&         rand_src,
+int                            count_of_itr,
+int                            population_size,
+int                            children_per_itr,
+int                            max_children_per_pair,
+int                            max_v_count_crossover,
+int                            mutations_per_1000,
+tsp::Crossover                 crossover_kind,
+tsp::LocalSearch               local_search,
+int                            local_search_moves,
+const util::neighbours::Lists& candidates,
+const population::EdgeKeys&    edge_keys,
+Migration*                     migration,
+std::atomic<bool>&             stop,
+const util::anytime::Deadline& deadline) noexcept {
+  const int v_count {static_cast<int>(matrix.size())};
+
+  // members after reproduction, mutation and migration never exceed this, so
+  // no slot is allocated after the first iteration
+  Population population {v_count,
+                         population_size + children_per_itr +
+                         mutations_per_1000 + 1 +
+                         (migration != nullptr
+                          ? migration->count * MIGRATION_BACKLOG
+                          : 0),
+                         edge_keys};
+
+  init_population(matrix, // O(population_count^2), mem O(population_size * n)
+                  initial_tour,
+                  rand_src,
+                  population,
+                  population_size);
+  util::anytime::record(population.cost(population.at(0)));
+
+  std::vector<Slot> children {}; // mem O(children_per_itr)
+  children.reserve(children_per_itr);
+  Scratch scratch {make_scratch(v_count)}; // mem O(n)
+  util::local_search::Engine engine {
+    matrix, candidates, graph_info.symmetric_graph}; // mem O(n)
+
+  std::geometric_distribution mutated_dist {0.5};
 
   for (int itr {0}; itr < count_of_itr; ++itr) {
-    // if optimal solution is found, end early
-    if (population.begin()->cost == optimal_cost) [[unlikely]] {
+    // if optimal solution is found here or on another island or out of time, end early
+    if (population.cost(population.at(0)) == optimal_cost) [[unlikely]] {
+      stop.store(true, std::memory_order_relaxed);
+      break;
+    }
+    if (deadline.passed(itr) || stop.load(std::memory_order_relaxed))
+    [[unlikely]] {
       break;
     }
 
-    reproduce(matrix, // O(children_per_itr^2 + children_per_itr * (log(population_size + children_per_itr) + population_size)), mem O(children_per_itr)
+    reproduce(matrix, // O(children_per_itr * (population_size + children_per_itr + n)), mem O(children_per_itr)
+              graph_info,
               rand_src,
               population,
+              scratch,
+              children,
+              crossover_kind,
+              engine,
+              local_search,
+              local_search_moves,
               children_per_itr,
               max_children_per_pair,
               max_v_count_crossover);
 
     // mutate based on mutation chance, the base is chosen on geometric distribution basis, if mutation is successful add to population
-    for (int mutation_chance {0}; mutation_chance < mutations_per_1000; ++mutation_chance) { // O(mutations_per_1000 * (population_size + children_per_itr + log(population_size + children_per_itr)))
-      if (mutation_dist(rand_src) == 0) {
+    for (int mutation_chance {0}; mutation_chance < mutations_per_1000; ++mutation_chance) { // O(mutations_per_1000 * (population_size + children_per_itr + n))
+      if (rand_src.below(2) == 0) {
         const int to_mutate {std::min(static_cast<int>(population.size() - 1),
                                       mutated_dist(rand_src))};
-        if (auto mutated {mutate(matrix,
-                                 rand_src,
-                                 *std::ranges::next(population.begin(),
-                                                    to_mutate,
-                                                    population.end()))};
+        if (const auto mutated {mutate(matrix,
+                                       rand_src,
+                                       population,
+                                       population.at(to_mutate))};
             mutated.has_value()) {
-          population.emplace(std::move(mutated.value()));
+          population.insert(*mutated);
         }
       }
     }
 
-    cut(population, population_size); // O(population_size + children_per_itr)
+    if (migration != nullptr && (itr + 1) % migration->interval == 0) {
+      migrate(population, *migration); // O(migrants * (population_size + n))
+    }
+
+    population.cut(population_size); // O(children_per_itr) - slots back to the pool
+    util::anytime::record(population.cost(population.at(0)));
   }
 
-  return tsp::Solution {.path = population.begin()->path,
-                        .cost = population.begin()->cost};
+  const std::span<const int> best_path {
+    std::as_const(population).path(population.at(0))};
+
+  return tsp::Solution {.path = {best_path.begin(), best_path.end()},
+                        .cost = population.cost(population.at(0))};
+}
+
+// every island is a task of the shared pool with its own stream of the run
+// seed, the best one is returned
+[[nodiscard]] static std::variant<tsp::Solution, tsp::ErrorAlgorithm> algorithm(
+const tsp::CostMatrix&         matrix,
+const tsp::GraphInfo&          graph_info,
+const std::optional<int>&      optimal_cost,
+int                            count_of_itr,
+int                            population_size,
+int                            children_per_itr,
+int                            max_children_per_pair,
+int                            max_v_count_crossover,
+int                            mutations_per_1000,
+tsp::Crossover                 crossover_kind,
+tsp::LocalSearch               local_search,
+int                            local_search_moves,
+const util::neighbours::Lists& neighbours,
+int                            island_count,
+int                            migration_interval,
+int                            migrant_count,
+tsp::Construction              initial,
+const util::anytime::Deadline& deadline) noexcept {
+  std::atomic<bool> stop {false};
+
+  // built once and shared by the islands, O(n^2) for nn
+  auto initial_result {
+    util::construct::tour(matrix, graph_info, optimal_cost, initial)};
+  if (std::holds_alternative<tsp::ErrorAlgorithm>(initial_result))
+  [[unlikely]] {
+    return std::get<tsp::ErrorAlgorithm>(initial_result);
+  }
+  const tsp::Solution& initial_tour {std::get<tsp::Solution>(initial_result)};
+
+  const util::neighbours::Lists candidates {neighbours.narrowed(
+  local_search == tsp::LocalSearch::NONE ? 0 : LOCAL_SEARCH_NEIGHBOURS)};
+  const population::EdgeKeys edge_keys {
+    static_cast<int>(matrix.size()), graph_info.symmetric_graph}; // mem O(n^2)
+
+  if (island_count == 1) {
+    util::rng::Xoshiro256 rand_src {util::rng::stream(0)};
+    return evolve(matrix,
+                  graph_info,
+                  optimal_cost,
+                  initial_tour,
+                  rand_src,
+                  count_of_itr,
+                  population_size,
+                  children_per_itr,
+                  max_children_per_pair,
+                  max_v_count_crossover,
+                  mutations_per_1000,
+                  crossover_kind,
+                  local_search,
+                  local_search_moves,
+                  candidates,
+                  edge_keys,
+                  nullptr,
+                  stop,
+                  deadline);
+  }
+
+  // queue i is filled by island i - 1 and drained by island i
+  const Migrant prototype {
+    .path = std::vector(matrix.size() + 1, 0), .cost = 0, .hash = 0};
+  std::vector<std::unique_ptr<MigrantQueue>> queues {};
+  queues.reserve(island_count);
+  for (int island {0}; island < island_count; ++island) {
+    queues.push_back(std::make_unique<MigrantQueue>(
+    static_cast<size_t>(std::max(migrant_count, 1) * MIGRATION_BACKLOG),
+    prototype));
+  }
+
+  std::vector<std::variant<tsp::Solution, tsp::ErrorAlgorithm>> results(
+  island_count);
+
+  util::parallel::shared_pool().run(
+  island_count, [&](int /*worker*/, int island) noexcept {
+    util::rng::Xoshiro256 rand_src {util::rng::stream(island)};
+    Migration             migration {
+                  .incoming = *queues[island],
+                  .outgoing = *queues[(island + 1) % island_count],
+                  .interval = migration_interval,
+                  .count    = migrant_count};
+
+    results[island] = evolve(matrix,
+                             graph_info,
+                             optimal_cost,
+                             initial_tour,
+                             rand_src,
+                             count_of_itr,
+                             population_size,
+                             children_per_itr,
+                             max_children_per_pair,
+                             max_v_count_crossover,
+                             mutations_per_1000,
+                             crossover_kind,
+                             local_search,
+                             local_search_moves,
+                             candidates,
+                             edge_keys,
+                             &migration,
+                             stop,
+                             deadline);
+  });
+
+  std::optional<tsp::Solution> best {};
+  for (auto& result : results) {
+    if (std::holds_alternative<tsp::ErrorAlgorithm>(result)) [[unlikely]] {
+      return std::get<tsp::ErrorAlgorithm>(result);
+    }
+    if (auto& solution {std::get<tsp::Solution>(result)};
+        !best.has_value() || solution.cost < best->cost) {
+      best = std::move(solution);
+    }
+  }
+  return *std::move(best);
 }
 
 }    // namespace gen::impl
 
 namespace gen {
 
+[[nodiscard]] int neighbour_width(
+const tsp::LocalSearch local_search) noexcept {
+  return local_search == tsp::LocalSearch::NONE
+         ? 0
+         : impl::LOCAL_SEARCH_NEIGHBOURS;
+}
+
 [[nodiscard]] std::variant<tsp::Solution, tsp::ErrorAlgorithm> run(
-const tsp::Matrix<int>&   matrix,
-const tsp::GraphInfo&     graph_info,
-const std::optional<int>& optimal_cost,
-int                       count_of_itr,
-int                       population_size,
-int                       children_per_itr,
-int                       max_children_per_pair,
-int                       max_v_count_crossover,
-int                       mutations_per_1000) noexcept {
+const tsp::CostMatrix&         matrix,
+const tsp::GraphInfo&          graph_info,
+const std::optional<int>&      optimal_cost,
+int                            count_of_itr,
+int                            population_size,
+int                            children_per_itr,
+int                            max_children_per_pair,
+int                            max_v_count_crossover,
+int                            mutations_per_1000,
+tsp::Crossover                 crossover_kind,
+tsp::LocalSearch               local_search,
+int                            local_search_moves,
+const util::neighbours::Lists& neighbours,
+int                            island_count,
+int                            migration_interval,
+int                            migrant_count,
+tsp::Construction              initial,
+int                            time_ms) noexcept {
+  const util::anytime::Deadline deadline {time_ms};
+
   if (count_of_itr < 1 || population_size < 2 || children_per_itr < 1 ||
       max_children_per_pair < 1 || mutations_per_1000 < 0 ||
-      mutations_per_1000 > 1000) [[unlikely]] {
+      mutations_per_1000 > 1000 || island_count < 1 ||
+      local_search_moves < 0 || migration_interval < 1 || migrant_count < 0 ||
+      migrant_count > population_size || time_ms < 0) [[unlikely]] {
+    return tsp::ErrorAlgorithm::INVALID_PARAM;
+  }
+
+  // lists are never wider than n - 1
+  if (neighbours.k() <
+      std::min(neighbour_width(local_search),
+               std::max(static_cast<int>(matrix.size()) - 1, 0))) [[unlikely]] {
     return tsp::ErrorAlgorithm::INVALID_PARAM;
   }
 
@@ -409,7 +942,7 @@ int                       mutations_per_1000) noexcept {
   }
 
   if (matrix.size() == 2) [[unlikely]] {    // edge case: 2 vertices
-    return nn::run(matrix, graph_info, optimal_cost);
+    return nn::run(matrix, graph_info, optimal_cost, nn::SINGLE_PATH);
   }
 
   return impl::algorithm(matrix,
@@ -420,7 +953,16 @@ int                       mutations_per_1000) noexcept {
                          children_per_itr,
                          max_children_per_pair,
                          max_v_count_crossover,
-                         mutations_per_1000);
+                         mutations_per_1000,
+                         crossover_kind,
+                         local_search,
+                         local_search_moves,
+                         neighbours,
+                         island_count,
+                         migration_interval,
+                         migrant_count,
+                         initial,
+                         deadline);
 }
 
 }    // namespace gen
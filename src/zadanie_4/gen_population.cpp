@@ -0,0 +1,188 @@
+#include "zadanie_4/gen_population.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace gen::population {
+
+// keys come from splitmix64 with a fixed seed, hashes only have to be equal
+// for equal tours within one run
+EdgeKeys::EdgeKeys(const int v_count, const bool symmetric) noexcept:
+  v_count {static_cast<size_t>(v_count)},
+  keys(static_cast<size_t>(v_count) * v_count) {
+  uint64_t state {0};
+  const auto next {[&state]() noexcept {
+    uint64_t key {state += 0x9E3779B97F4A7C15};
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EB;
+    return key ^ (key >> 31);
+  }};
+
+  for (size_t from {0}; from < this->v_count; ++from) {
+    for (size_t to {symmetric ? from : 0}; to < this->v_count; ++to) {
+      keys[from * this->v_count + to] = next();
+      if (symmetric) {
+        keys[to * this->v_count + from] = keys[from * this->v_count + to];
+      }
+    }
+  }
+}
+
+// load factor kept at or below 1/2
+TourSet::TourSet(const int capacity) noexcept:
+  entries(std::bit_ceil(2 * static_cast<size_t>(std::max(capacity, 1)))),
+  mask {entries.size() - 1} {
+}
+
+bool TourSet::insert(const uint64_t hash) noexcept {
+  if (2 * (count + 1) > entries.size()) [[unlikely]] {
+    grow();
+  }
+
+  size_t index {home(hash)};
+  while (entries[index].used) {
+    if (entries[index].hash == hash) {
+      return false;
+    }
+    index = (index + 1) & mask;
+  }
+
+  entries[index] = {.hash = hash, .used = true};
+  ++count;
+  return true;
+}
+
+void TourSet::erase(const uint64_t hash) noexcept {
+  size_t index {home(hash)};
+  while (entries[index].used && entries[index].hash != hash) {
+    index = (index + 1) & mask;
+  }
+  if (!entries[index].used) [[unlikely]] {
+    return;
+  }
+
+  // entries after the hole move back unless they already sit between their
+  // home and the hole
+  size_t hole {index};
+  for (size_t next {(hole + 1) & mask}; entries[next].used;
+       next = (next + 1) & mask) {
+    const size_t next_home {home(entries[next].hash)};
+    if (((next - next_home) & mask) >= ((next - hole) & mask)) {
+      entries[hole] = entries[next];
+      hole          = next;
+    }
+  }
+  entries[hole].used = false;
+  --count;
+}
+
+void TourSet::grow() noexcept {
+  std::vector<Entry> old(entries.size() * 2);
+  old.swap(entries);
+  mask  = entries.size() - 1;
+  count = 0;
+  for (const Entry& entry : old) {
+    if (entry.used) {
+      insert(entry.hash);
+    }
+  }
+}
+
+Population::Population(const int       v_count,
+                       const int       capacity,
+                       const EdgeKeys& edge_keys) noexcept:
+  v_count {static_cast<size_t>(v_count)},
+  stride {2 * static_cast<size_t>(v_count) + 1},
+  edge_keys {edge_keys},
+  genes(stride * capacity),
+  costs(capacity),
+  hashes(capacity),
+  member_hashes {capacity} {
+  members.reserve(capacity);
+  free_slots.reserve(capacity);
+
+  // lowest slots are handed out first
+  for (Slot slot {capacity - 1}; slot >= 0; --slot) {
+    free_slots.push_back(slot);
+  }
+}
+
+Slot Population::acquire() noexcept {
+  if (free_slots.empty()) [[unlikely]] {
+    const Slot slot {static_cast<Slot>(costs.size())};
+    genes.resize(genes.size() + stride);
+    costs.push_back(0);
+    hashes.push_back(0);
+    return slot;
+  }
+
+  const Slot slot {free_slots.back()};
+  free_slots.pop_back();
+  return slot;
+}
+
+void Population::release(const Slot slot) noexcept {
+  free_slots.push_back(slot);
+}
+
+void Population::copy(const Slot from, const Slot to) noexcept {
+  std::copy_n(genes.begin() + from * stride, stride, genes.begin() + to * stride);
+  costs[to]  = costs[from];
+  hashes[to] = hashes[from];
+}
+
+void Population::rehash(const Slot slot) noexcept {
+  const std::span<const int> tour {std::as_const(*this).path(slot)};
+
+  uint64_t hash {0};
+  for (size_t i {0}; i < v_count; ++i) {
+    hash ^= edge_key(tour[i], tour[i + 1]);
+  }
+  hashes[slot] = hash;
+}
+
+bool Population::insert(const Slot slot) noexcept {
+  if (!member_hashes.insert(hashes[slot])) { // O(1) expected
+    release(slot);
+    return false;
+  }
+
+  const auto position {std::ranges::lower_bound(
+  members, slot, [this](Slot lhs, Slot rhs) noexcept {
+    return compare(lhs, rhs) < 0;
+  })};
+
+  members.insert(position, slot);
+  return true;
+}
+
+void Population::cut(const size_t count) noexcept {
+  if (members.size() <= count) {
+    return;
+  }
+
+  for (auto member {members.begin() + count}; member != members.end();
+       ++member) {
+    member_hashes.erase(hashes[*member]);
+  }
+  free_slots.insert(free_slots.end(), members.begin() + count, members.end());
+  members.resize(count);
+}
+
+// cost first, equal costs are ordered by hash so the order is total
+std::weak_ordering Population::compare(const Slot lhs,
+                                       const Slot rhs) const noexcept {
+  if (const auto result = costs[lhs] <=> costs[rhs];
+      result != std::strong_ordering::equal) {
+    return result;
+  }
+  return hashes[lhs] <=> hashes[rhs];
+}
+
+}    // namespace gen::population